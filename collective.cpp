@@ -25,6 +25,7 @@
 #include "options.h"
 #include "technology.h"
 #include "music.h"
+#include "profiler.h"
 
 template <class Archive> 
 void Collective::serialize(Archive& ar, const unsigned int version) {
@@ -84,7 +85,9 @@ void Collective::TaskMap::serialize(Archive& ar, const unsigned int version) {
   ar& SUBCLASS(Task::Mapping)
     & BOOST_SERIALIZATION_NVP(marked)
     & BOOST_SERIALIZATION_NVP(lockedTasks)
-    & BOOST_SERIALIZATION_NVP(completionCost);
+    & BOOST_SERIALIZATION_NVP(completionCost)
+    & BOOST_SERIALIZATION_NVP(delayedTasks)
+    & BOOST_SERIALIZATION_NVP(delayTimeouts);
 }
 
 SERIALIZABLE(Collective::TaskMap);
@@ -280,7 +283,8 @@ map<MinionTask, MinionTaskInfo> taskInfo {
     {MinionTask::TORTURE, {SquareType::TORTURE_TABLE, "tortured", Collective::Warning::TORTURE_ROOM}},
 };
 
-Collective::Collective(Model* m, Level* l, Tribe* t) : level(l), mana(200), model(m), tribe(t),
+Collective::Collective(Model* m, Level* l, Tribe* t) : delayedPos(l->getBounds()), myTiles(l->getBounds()),
+    level(l), borderTiles(l->getBounds()), mana(200), model(m), tribe(t),
     sectors(new Sectors(l->getBounds())), flyingSectors(new Sectors(l->getBounds())) {
   bool hotkeys[128] = {0};
   for (BuildInfo info : concat(buildInfo, workshopInfo)) {
@@ -297,13 +301,13 @@ Collective::Collective(Model* m, Level* l, Tribe* t) : level(l), mana(200), mode
   }
   memory.reset(new map<Level*, MapMemory>);
   // init the map so the values can be safely read with .at()
-  mySquares[SquareType::TREE_TRUNK].clear();
-  mySquares[SquareType::IMPALED_HEAD].clear();
-  mySquares[SquareType::FLOOR].clear();
-  mySquares[SquareType::TRIBE_DOOR].clear();
+  getSquares(SquareType::TREE_TRUNK).clear();
+  getSquares(SquareType::IMPALED_HEAD).clear();
+  getSquares(SquareType::FLOOR).clear();
+  getSquares(SquareType::TRIBE_DOOR).clear();
   for (BuildInfo info : concat(buildInfo, workshopInfo))
     if (info.buildType == BuildInfo::SQUARE)
-      mySquares[info.squareInfo.type].clear();
+      getSquares(info.squareInfo.type).clear();
   credit = {
     {ResourceId::GOLD, 0},
     {ResourceId::WOOD, 0},
@@ -378,16 +382,18 @@ void Collective::retire() {
   retired = true;
 }
 
-vector<pair<Item*, Vec2>> Collective::getTrapItems(TrapType type, set<Vec2> squares) const {
+vector<pair<Item*, Vec2>> Collective::getTrapItems(TrapType type, bool onlyWorkshops) const {
   vector<pair<Item*, Vec2>> ret;
-  if (squares.empty())
-    squares = mySquares.at(SquareType::WORKSHOP);
-  for (Vec2 pos : squares) {
-    vector<Item*> v = level->getSquare(pos)->getItems([type, this](Item* it) {
-        return it->getTrapType() == type && !isItemMarked(it); });
-    for (Item* it : v)
-      ret.emplace_back(it, pos);
-  }
+  updateItemIndex();
+  if (!trapItemPositions.count(type))
+    return ret;
+  for (Vec2 pos : trapItemPositions.at(type))
+    if (!onlyWorkshops || getSquares(SquareType::WORKSHOP).contains(pos)) {
+      vector<Item*> v = level->getSquare(pos)->getItems([type, this](Item* it) {
+          return it->getTrapType() == type && !isItemMarked(it); });
+      for (Item* it : v)
+        ret.emplace_back(it, pos);
+    }
   return ret;
 }
 
@@ -651,20 +657,128 @@ static int getItemValue(const Item* it) {
     + it->getModifier(AttrType::DEFENSE);
 }
 
+TileSet& Collective::getSquares(SquareType type) {
+  if (!mySquares.count(type))
+    mySquares.insert(make_pair(type, TileSet(level->getBounds())));
+  return mySquares.at(type);
+}
+
+const TileSet& Collective::getSquares(SquareType type) const {
+  return mySquares.at(type);
+}
+
+void Collective::onItemsChangedEvent(const Level* l, Vec2 pos) {
+  if (l == level) {
+    if (itemIndexValid && myTiles.contains(pos))
+      dirtyItemPositions.insert(pos);
+    addHaulingPos(pos);
+  }
+}
+
+void Collective::updateItemIndex() const {
+  if (!itemIndexValid) {
+    itemPositions.clear();
+    sortedItems.clear();
+    trapItemPositions.clear();
+    dirtyItemPositions = TileSet(level->getBounds());
+    for (Vec2 v : myTiles)
+      dirtyItemPositions.insert(v);
+    itemIndexValid = true;
+  }
+  for (Vec2 pos : dirtyItemPositions) {
+    for (auto& elem : itemPositions)
+      if (elem.second.contains(pos)) {
+        elem.second.erase(pos);
+        unsortedTypes.insert(elem.first);
+      }
+    for (auto& elem : trapItemPositions)
+      elem.second.erase(pos);
+    for (Item* it : level->getSquare(pos)->getItems()) {
+      if (!itemPositions.count(it->getType()))
+        itemPositions.insert(make_pair(it->getType(), TileSet(level->getBounds())));
+      itemPositions.at(it->getType()).insert(pos);
+      unsortedTypes.insert(it->getType());
+      if (Optional<TrapType> type = it->getTrapType()) {
+        if (!trapItemPositions.count(*type))
+          trapItemPositions.insert(make_pair(*type, TileSet(level->getBounds())));
+        trapItemPositions.at(*type).insert(pos);
+        trapItemsChanged.insert(*type);
+      }
+    }
+  }
+  dirtyItemPositions.clear();
+}
+
+const vector<Vec2>& Collective::getItemPositions(ItemType type) const {
+  static vector<Vec2> empty;
+  updateItemIndex();
+  if (itemPositions.count(type))
+    return itemPositions.at(type).getAll();
+  else
+    return empty;
+}
+
+bool Collective::hasItemOnTerritory(ItemPredicate predicate) const {
+  updateItemIndex();
+  for (auto& elem : itemPositions)
+    for (Vec2 v : elem.second)
+      for (Item* it : level->getSquare(v)->getItems())
+        if (it->getType() == elem.first && predicate(it))
+          return true;
+  return false;
+}
+
+static bool isMoreValuable(const Item* it1, const Item* it2) {
+  int diff = getItemValue(it1) - getItemValue(it2);
+  if (diff == 0)
+    return it1->getUniqueId() < it2->getUniqueId();
+  else
+    return diff > 0;
+}
+
+const vector<Item*>& Collective::getSortedItems(ItemType type) const {
+  updateItemIndex();
+  if (unsortedTypes.count(type) || !sortedItems.count(type)) {
+    vector<Item*>& items = sortedItems[type];
+    items.clear();
+    for (Vec2 v : getItemPositions(type))
+      for (Item* it : level->getSquare(v)->getItems())
+        if (it->getType() == type)
+          items.push_back(it);
+    sort(items.begin(), items.end(), isMoreValuable);
+    unsortedTypes.erase(type);
+  }
+  return sortedItems.at(type);
+}
+
+// merges the already sorted buckets instead of sorting everything again
 vector<Item*> Collective::getAllItems(ItemPredicate predicate, bool includeMinions) const {
   vector<Item*> allItems;
-  for (Vec2 v : myTiles)
-    append(allItems, level->getSquare(v)->getItems(predicate));
-  if (includeMinions)
-    for (Creature* c : creatures)
-      append(allItems, c->getEquipment().getItems(predicate));
-  sort(allItems.begin(), allItems.end(), [](const Item* it1, const Item* it2) {
-      int diff = getItemValue(it1) - getItemValue(it2);
-      if (diff == 0)
-        return it1->getUniqueId() < it2->getUniqueId();
-      else
-        return diff > 0;
-    });
+  updateItemIndex();
+  for (auto& elem : itemPositions) {
+    int sortedSize = allItems.size();
+    for (Item* it : getSortedItems(elem.first))
+      if (predicate(it))
+        allItems.push_back(it);
+    inplace_merge(allItems.begin(), allItems.begin() + sortedSize, allItems.end(), isMoreValuable);
+  }
+  return sortedWithMinionItems(allItems, predicate, includeMinions);
+}
+
+vector<Item*> Collective::getAllItems(ItemType type, ItemPredicate predicate, bool includeMinions) const {
+  return sortedWithMinionItems(filter(getSortedItems(type), predicate), predicate, includeMinions);
+}
+
+// only the minion equipment is sorted, the territory items are expected to be sorted already
+vector<Item*> Collective::sortedWithMinionItems(vector<Item*> allItems, ItemPredicate predicate,
+    bool includeMinions) const {
+  if (!includeMinions)
+    return allItems;
+  int sortedSize = allItems.size();
+  for (Creature* c : creatures)
+    append(allItems, c->getEquipment().getItems(predicate));
+  sort(allItems.begin() + sortedSize, allItems.end(), isMoreValuable);
+  inplace_merge(allItems.begin(), allItems.begin() + sortedSize, allItems.end(), isMoreValuable);
   return allItems;
 }
 
@@ -710,7 +824,7 @@ Item* Collective::chooseEquipmentItem(View* view, Item* currentItem, ItemPredica
 }
 
 void Collective::handleMarket(View* view, int prevItem) {
-  if (mySquares[SquareType::STOCKPILE].empty()) {
+  if (getSquares(SquareType::STOCKPILE).empty()) {
     view->presentText("Information", "You need a storage room to use the market.");
     return;
   }
@@ -724,7 +838,7 @@ void Collective::handleMarket(View* view, int prevItem) {
   auto index = view->chooseFromList("Buy items", options, prevItem);
   if (!index)
     return;
-  Vec2 dest = chooseRandom(mySquares[SquareType::STOCKPILE]);
+  Vec2 dest = getSquares(SquareType::STOCKPILE).getRandom();
   takeGold({ResourceId::GOLD, items[*index]->getPrice()});
   level->getSquare(dest)->dropItem(std::move(items[*index]));
   view->updateView(this);
@@ -842,7 +956,7 @@ int Collective::getNumMinions() const {
 
 void Collective::handleSpawning(View* view, SquareType spawnSquare, const string& info1, const string& info2,
     const string& title, MinionType minionType, vector<SpawnInfo> spawnInfo) {
-  set<Vec2> cages = mySquares.at(spawnSquare);
+  vector<Vec2> cages = getSquares(spawnSquare).getAll();
   int prevItem = 0;
   bool allInactive = false;
   while (1) {
@@ -891,7 +1005,7 @@ void Collective::handleSpawning(View* view, SquareType spawnSquare, const string
 }
 
 void Collective::handleNecromancy(View* view, int prevItem, bool firstTime) {
-  set<Vec2> graves = mySquares.at(SquareType::GRAVE);
+  vector<Vec2> graves = getSquares(SquareType::GRAVE).getAll();
   vector<View::ListElem> options;
   bool allInactive = false;
   if (getNumMinions() >= minionLimit) {
@@ -963,13 +1077,13 @@ double Collective::getTechCost() {
 }
 
 void Collective::handleLibrary(View* view) {
-  if (mySquares.at(SquareType::LIBRARY).empty()) {
+  if (getSquares(SquareType::LIBRARY).empty()) {
     view->presentText("", "You need to build a library to start research.");
     return;
   }
   vector<View::ListElem> options;
   bool allInactive = false;
-  if (mySquares.at(SquareType::LIBRARY).size() <= getMinLibrarySize()) {
+  if (getSquares(SquareType::LIBRARY).size() <= getMinLibrarySize()) {
     allInactive = true;
     options.emplace_back("You need a larger library to continue research.", View::TITLE);
   }
@@ -1023,7 +1137,7 @@ vector<Button> Collective::fillButtons(const vector<BuildInfo>& buildInfo) const
                 SquareFactory::get(elem.type)->getViewObject(),
                 elem.name,
                 cost,
-                (elem.cost.value > 0 ? "[" + convertToString(mySquares.at(elem.type).size()) + "]" : ""),
+                (elem.cost.value > 0 ? "[" + convertToString(getSquares(elem.type).size()) + "]" : ""),
                 isTech ? "" : "Requires " + Technology::get(*button.techId)->getName() });
            }
            break;
@@ -1244,9 +1358,16 @@ Vec2 Collective::getPosition() const {
 
 enum Selection { SELECT, DESELECT, NONE } selection = NONE;
 
+Task* Collective::TaskMap::addTask(PTask task, const Creature* c) {
+  Task* ret = Task::Mapping::addTask(std::move(task), c);
+  if (indexValid)
+    indexTask(ret);
+  return ret;
+}
+
 Task* Collective::TaskMap::addTaskCost(PTask task, CostInfo cost) {
   completionCost[task.get()] = cost;
-  return Task::Mapping::addTask(std::move(task));
+  return addTask(std::move(task));
 }
 
 Collective::CostInfo Collective::TaskMap::removeTask(Task* task) {
@@ -1257,6 +1378,8 @@ Collective::CostInfo Collective::TaskMap::removeTask(Task* task) {
   }
   if (marked.count(task->getPosition()))
     marked.erase(task->getPosition());
+  if (indexValid)
+    unindexTask(task);
   Task::Mapping::removeTask(task);
   return cost;
 }
@@ -1305,7 +1428,7 @@ bool Collective::hasGold(CostInfo cost) const {
 
 int Collective::numGold(ResourceId id) const {
   int ret = credit.at(id);
-  for (Vec2 pos : mySquares.at(resourceInfo.at(id).storageType))
+  for (Vec2 pos : getSquares(resourceInfo.at(id).storageType))
     ret += level->getSquare(pos)->getItems(resourceInfo.at(id).predicate).size();
   return ret;
 }
@@ -1324,7 +1447,7 @@ void Collective::takeGold(CostInfo cost) {
       credit[cost.id] = 0;
     }
   }
-  for (Vec2 pos : randomPermutation(mySquares[resourceInfo.at(cost.id).storageType])) {
+  for (Vec2 pos : randomPermutation(getSquares(resourceInfo.at(cost.id).storageType).getAll())) {
     vector<Item*> goldHere = level->getSquare(pos)->getItems(resourceInfo.at(cost.id).predicate);
     for (Item* it : goldHere) {
       level->getSquare(pos)->removeItem(it);
@@ -1339,10 +1462,10 @@ void Collective::returnGold(CostInfo amount) {
   if (amount.value == 0)
     return;
   CHECK(amount.value > 0);
-  if (mySquares[resourceInfo.at(amount.id).storageType].empty()) {
+  if (getSquares(resourceInfo.at(amount.id).storageType).empty()) {
     credit[amount.id] += amount.value;
   } else
-    level->getSquare(chooseRandom(mySquares[resourceInfo.at(amount.id).storageType]))->
+    level->getSquare(getSquares(resourceInfo.at(amount.id).storageType).getRandom())->
         dropItems(ItemFactory::fromId(resourceInfo.at(amount.id).itemId, amount.value));
 }
 
@@ -1546,15 +1669,16 @@ void Collective::handleSelection(Vec2 pos, const BuildInfo& building, bool recta
         if (traps.count(pos)) {
           traps.erase(pos);
         } else
-        if (canPlacePost(pos) && myTiles.count(pos)) {
+        if (canPlacePost(pos) && myTiles.contains(pos)) {
           traps[pos] = {trapType, false, 0};
+          scheduleTrap(pos);
           updateConstructions();
         }
       }
       break;
     case BuildInfo::DESTROY:
         selection = SELECT;
-        if (level->getSquare(pos)->canDestroy() && myTiles.count(pos))
+        if (level->getSquare(pos)->canDestroy() && myTiles.contains(pos))
           level->getSquare(pos)->destroy();
         level->getSquare(pos)->removeTriggers();
         if (Creature* c = level->getSquare(pos)->getCreature())
@@ -1626,6 +1750,7 @@ void Collective::handleSelection(Vec2 pos, const BuildInfo& building, bool recta
                     --executions;
                 }
                 constructions[pos] = {info.cost, false, 0, info.type, -1};
+                scheduleConstruction(pos);
                 selection = SELECT;
                 updateConstructions();
               }
@@ -1671,10 +1796,15 @@ void Collective::addKnownTile(Vec2 pos) {
 }
 
 void Collective::onConstructed(Vec2 pos, SquareType type) {
-  if (!contains({SquareType::ANIMAL_TRAP, SquareType::TREE_TRUNK}, type))
+  if (!contains({SquareType::ANIMAL_TRAP, SquareType::TREE_TRUNK}, type)) {
     myTiles.insert(pos);
-  CHECK(!mySquares[type].count(pos));
-  mySquares[type].insert(pos);
+    if (itemIndexValid)
+      dirtyItemPositions.insert(pos);
+  }
+  addHaulingPos(pos);
+  dangerZoneDirty = true;
+  CHECK(!getSquares(type).contains(pos));
+  getSquares(type).insert(pos);
   if (contains({SquareType::FLOOR, SquareType::BRIDGE}, type))
     taskMap.clearAllLocked();
   if (taskMap.getMarked(pos))
@@ -1702,6 +1832,10 @@ void Collective::onPickedUp(Vec2 pos, EntitySet items) {
 void Collective::onCantPickItem(EntitySet items) {
   for (UniqueId id : items)
     unmarkItem(id);
+  // the items are still lying somewhere, so look at all squares again
+  haulingQueueValid = false;
+  for (auto& elem : waitingForTrapItem)
+    trapItemsChanged.insert(elem.first);
 }
 
 void Collective::onBrought(Vec2 pos, vector<Item*> items) {
@@ -1724,7 +1858,7 @@ set<TrapType> Collective::getNeededTraps() const {
 }
 
 void Collective::onAppliedSquare(Vec2 pos) {
-  if (mySquares.at(SquareType::LIBRARY).count(pos)) {
+  if (getSquares(SquareType::LIBRARY).contains(pos)) {
     Creature* c = NOTNULL(level->getSquare(pos)->getCreature());
     if (c == keeper)
       mana += 0.3 + max(0., 2 - (mana + double(getDangerLevel(false))) / 700);
@@ -1733,12 +1867,12 @@ void Collective::onAppliedSquare(Vec2 pos) {
         c->addSpell(chooseRandom(keeper->getSpells()).id);
     }
   }
-  if (mySquares.at(SquareType::LABORATORY).count(pos))
+  if (getSquares(SquareType::LABORATORY).contains(pos))
     if (Random.roll(30)) {
       level->getSquare(pos)->dropItems(ItemFactory::laboratory(technologies).random());
       Statistics::add(StatId::POTION_PRODUCED);
     }
-  if (mySquares.at(SquareType::WORKSHOP).count(pos))
+  if (getSquares(SquareType::WORKSHOP).contains(pos))
     if (Random.roll(40)) {
       set<TrapType> neededTraps = getNeededTraps();
       vector<PItem> items;
@@ -1756,8 +1890,10 @@ void Collective::onAppliedSquare(Vec2 pos) {
 }
 
 void Collective::onAppliedItemCancel(Vec2 pos) {
-  if (traps.count(pos))
+  if (traps.count(pos)) {
     traps.at(pos).marked = 0;
+    scheduleTrap(pos);
+  }
 }
 
 bool Collective::isRetired() const {
@@ -1770,17 +1906,35 @@ const Creature* Collective::getKeeper() const {
 
 Vec2 Collective::getDungeonCenter() const {
   if (!myTiles.empty())
-    return Vec2::getCenterOfWeight(vector<Vec2>(myTiles.begin(), myTiles.end()));
+    return Vec2::getCenterOfWeight(myTiles.getAll());
   else
     return keeper->getPosition();
 }
 
+void Collective::updateMinionPower() const {
+  minionPoints.clear();
+  minionPower = 0;
+  for (const Creature* c : minions) {
+    minionPoints[c] = c->getDifficultyPoints();
+    minionPower += minionPoints.at(c);
+  }
+  minionPowerValid = true;
+}
+
+void Collective::onDifficultyChangedEvent(const Creature* c) {
+  if (minionPowerValid && minionPoints.count(c)) {
+    int points = c->getDifficultyPoints();
+    minionPower += points - minionPoints.at(c);
+    minionPoints[c] = points;
+  }
+}
+
 double Collective::getDangerLevel(bool includeExecutions) const {
-  double ret = 0;
-  for (const Creature* c : minions)
-    ret += c->getDifficultyPoints();
+  if (!minionPowerValid)
+    updateMinionPower();
+  double ret = minionPower;
   if (includeExecutions)
-    ret += mySquares.at(SquareType::IMPALED_HEAD).size() * 150;
+    ret += getSquares(SquareType::IMPALED_HEAD).size() * 150;
   return ret;
 }
 
@@ -1824,33 +1978,116 @@ bool Collective::isDownstairsVisible() const {
 // after this time applying trap or building door is rescheduled (imp death, etc).
 const static int timeToBuild = 50;
 
-void Collective::updateConstructions() {
-  map<TrapType, vector<pair<Item*, Vec2>>> trapItems;
-  for (const BuildInfo& info : workshopInfo)
-    if (info.buildType == BuildInfo::TRAP)
-      trapItems[info.trapInfo.type] = getTrapItems(info.trapInfo.type, myTiles);
-  for (auto elem : traps)
-    if (!isDelayed(elem.first)) {
-      vector<pair<Item*, Vec2>>& items = trapItems.at(elem.second.type);
-      if (!items.empty()) {
-        if (!elem.second.armed && elem.second.marked <= getTime()) {
-          taskMap.addTask(Task::applyItem(this, items.back().second, items.back().first, elem.first));
-          markItem(items.back().first);
-          items.pop_back();
-          traps[elem.first].marked = getTime() + timeToBuild;
-        }
+void Collective::scheduleConstruction(Vec2 pos) {
+  if (dueQueuesValid)
+    constructionQueue.schedule(constructions.at(pos).marked, pos);
+}
+
+void Collective::scheduleTrap(Vec2 pos) {
+  if (dueQueuesValid)
+    trapQueue.schedule(traps.at(pos).marked, pos);
+}
+
+void Collective::updateDueQueues() {
+  if (!dueQueuesValid) {
+    constructionQueue.clear();
+    trapQueue.clear();
+    waitingForResource.clear();
+    waitingForTrapItem.clear();
+    for (auto& elem : constructions)
+      if (!elem.second.built)
+        constructionQueue.schedule(elem.second.marked, elem.first);
+    for (auto& elem : traps)
+      if (!elem.second.armed)
+        trapQueue.schedule(elem.second.marked, elem.first);
+    dueQueuesValid = true;
+  }
+  for (Vec2 pos : popDuePositions(constructionQueue, getTime(), delayedPos, [this] (Vec2 pos) {
+        if (!constructions.count(pos) || constructions.at(pos).built)
+          return -1.0;
+        return constructions.at(pos).marked; })) {
+    const ConstructionInfo& info = constructions.at(pos);
+    waitingForResource[info.cost.id].insert({info.cost.value, pos});
+  }
+  for (Vec2 pos : popDuePositions(trapQueue, getTime(), delayedPos, [this] (Vec2 pos) {
+        if (!traps.count(pos) || traps.at(pos).armed)
+          return -1.0;
+        return traps.at(pos).marked; })) {
+    waitingForTrapItem[traps.at(pos).type].insert(pos);
+    trapItemsChanged.insert(traps.at(pos).type);
+  }
+}
+
+// entries are validated when they come due, a changed time is always scheduled again
+vector<Vec2> Collective::popDuePositions(TimerWheel<Vec2>& queue, double time, const DelayMap& delays,
+    function<double(Vec2)> getMarked) {
+  vector<Vec2> ret;
+  for (Vec2 pos : queue.popDueInclusive(time)) {
+    double marked = getMarked(pos);
+    if (marked < 0 || marked > time)
+      continue;
+    if (delays.isDelayed(pos, time))
+      queue.schedule(delays.getDelayEnd(pos), pos);
+    else
+      ret.push_back(pos);
+  }
+  return ret;
+}
+
+void Collective::updateTraps() {
+  updateItemIndex();
+  for (auto& elem : waitingForTrapItem) {
+    if (elem.second.empty() || !trapItemsChanged.count(elem.first))
+      continue;
+    vector<pair<Item*, Vec2>> items = getTrapItems(elem.first, false);
+    for (Vec2 pos : copyThis(elem.second)) {
+      if (items.empty())
+        break;
+      elem.second.erase(pos);
+      if (!traps.count(pos) || traps.at(pos).armed || traps.at(pos).marked > getTime())
+        continue;
+      if (isDelayed(pos)) {
+        trapQueue.schedule(delayedPos.getDelayEnd(pos), pos);
+        continue;
       }
+      taskMap.addTask(Task::applyItem(this, items.back().second, items.back().first, pos));
+      markItem(items.back().first);
+      items.pop_back();
+      traps.at(pos).marked = getTime() + timeToBuild;
+      scheduleTrap(pos);
     }
-  for (auto& elem : constructions)
-    if (!isDelayed(elem.first) && elem.second.marked <= getTime() && !elem.second.built) {
-      if ((warning[int(resourceInfo.at(elem.second.cost.id).warning)]
-          = (numGold(elem.second.cost.id) < elem.second.cost.value)))
+  }
+  trapItemsChanged.clear();
+}
+
+void Collective::updateConstructions() {
+  updateDueQueues();
+  updateTraps();
+  for (auto& elem : waitingForResource) {
+    ResourceId resource = elem.first;
+    // waiting constructions are ordered by cost, so the first one that can't be paid stops the rest
+    while (!elem.second.empty()) {
+      Vec2 pos = elem.second.begin()->second;
+      if (!constructions.count(pos) || constructions.at(pos).built
+          || constructions.at(pos).cost.id != resource || constructions.at(pos).marked > getTime()) {
+        elem.second.erase(elem.second.begin());
+        continue;
+      }
+      ConstructionInfo& info = constructions.at(pos);
+      if (isDelayed(pos)) {
+        elem.second.erase(elem.second.begin());
+        constructionQueue.schedule(delayedPos.getDelayEnd(pos), pos);
         continue;
-      elem.second.task = taskMap.addTaskCost(Task::construction(this, elem.first, elem.second.type),
-          elem.second.cost)->getUniqueId();
-      elem.second.marked = getTime() + timeToBuild;
-      takeGold(elem.second.cost);
+      }
+      if ((warning[int(resourceInfo.at(resource).warning)] = (numGold(resource) < info.cost.value)))
+        break;
+      elem.second.erase(elem.second.begin());
+      info.task = taskMap.addTaskCost(Task::construction(this, pos, info.type), info.cost)->getUniqueId();
+      info.marked = getTime() + timeToBuild;
+      scheduleConstruction(pos);
+      takeGold(info.cost);
     }
+  }
 }
 
 double Collective::getTime() const {
@@ -1858,93 +2095,121 @@ double Collective::getTime() const {
 }
 
 void Collective::delayDangerousTasks(const vector<Vec2>& enemyPos, double delayTime) {
-  int infinity = 1000000;
   int radius = 10;
-  Table<int> dist(Rectangle::boundingBox(enemyPos).minusMargin(-radius).intersection(level->getBounds()), infinity);
+  if (dangerDistance.getWidth() != level->getBounds().getW()
+      || dangerDistance.getHeight() != level->getBounds().getH())
+    dangerDistance = Table<int>(level->getBounds(), -1);
+  vector<Vec2> visited;
   queue<Vec2> q;
-  for (Vec2 v : enemyPos) {
-    dist[v] = 0;
-    q.push(v);
-  }
+  for (Vec2 v : enemyPos)
+    if (dangerDistance[v] == -1) {
+      dangerDistance[v] = 0;
+      visited.push_back(v);
+      q.push(v);
+    }
   while (!q.empty()) {
     Vec2 pos = q.front();
     q.pop();
-    delayedPos[pos] = delayTime;
-    if (dist[pos] >= radius)
+    delayedPos.delay(pos, delayTime);
+    if (dangerDistance[pos] >= radius)
       continue;
     for (Vec2 v : pos.neighbors8())
-      if (v.inRectangle(dist.getBounds()) && dist[v] == infinity &&
-          /*level->getSquare(v)->canEnterEmpty(Creature::getDefault()) &&*/ myTiles.count(v)) {
-        dist[v] = dist[pos] + 1;
+      if (v.inRectangle(level->getBounds()) && dangerDistance[v] == -1 &&
+          /*level->getSquare(v)->canEnterEmpty(Creature::getDefault()) &&*/ myTiles.contains(v)) {
+        dangerDistance[v] = dangerDistance[pos] + 1;
+        visited.push_back(v);
         q.push(v);
       }
   }
+  for (Vec2 v : visited)
+    dangerDistance[v] = -1;
 }
 
 bool Collective::isDelayed(Vec2 pos) {
-  return delayedPos.count(pos) && delayedPos.at(pos) > getTime();
+  return delayedPos.isDelayed(pos, getTime());
+}
+
+const int dangerZoneRadius = 10;
+
+void Collective::updateDangerZone() {
+  dangerZone = Table<int>(level->getBounds(), -1);
+  queue<Vec2> q;
+  for (Vec2 pos : myTiles) {
+    dangerZone[pos] = 0;
+    q.push(pos);
+  }
+  while (!q.empty()) {
+    Vec2 pos = q.front();
+    q.pop();
+    if (dangerZone[pos] + 1 >= dangerZoneRadius)
+      continue;
+    for (Vec2 v : pos.neighbors8())
+      if (v.inRectangle(level->getBounds()) && dangerZone[v] == -1
+          && level->getSquare(v)->canEnterEmpty(Creature::getDefault())) {
+        dangerZone[v] = dangerZone[pos] + 1;
+        q.push(v);
+      }
+  }
+  dangerZoneDirty = false;
+  intruders.clear();
+  for (const Creature* c : level->getAllCreatures())
+    onMoveEvent(c);
+}
+
+bool Collective::isInDangerZone(Vec2 pos) const {
+  return !dangerZoneDirty && dangerZone[pos] > -1;
+}
+
+void Collective::onMoveEvent(const Creature* c) {
+  if (c->getLevel() == level && c->getTribe() != tribe && isInDangerZone(c->getPosition()))
+    intruders.insert(c);
+}
+
+vector<Vec2> Collective::getIntruderPositions() {
+  if (dangerZoneDirty)
+    updateDangerZone();
+  vector<Vec2> ret;
+  for (const Creature* c : copyThis(intruders))
+    if (c->isDead() || c->getLevel() != level || c->getTribe() == tribe || !isInDangerZone(c->getPosition()))
+      intruders.erase(c);
+    else
+      ret.push_back(c->getPosition());
+  return ret;
 }
 
 void Collective::tick() {
+  PROFILE("collective tick");
   model->getView()->getJukebox()->update();
   if (retired) {
     if (const Creature* c = level->getPlayer())
-      if (Random.roll(30) && !myTiles.count(c->getPosition()))
+      if (Random.roll(30) && !myTiles.contains(c->getPosition()))
         c->playerMessage("You sense horrible evil in the " + 
             getCardinalName((keeper->getPosition() - c->getPosition()).getBearing().getCardinalDir()));
   }
   updateVisibleCreatures();
+  taskMap.releaseDelayedTasks(getTime());
+  delayedPos.expire(getTime());
   warning[int(Warning::MANA)] = mana < 100;
   warning[int(Warning::WOOD)] = numGold(ResourceId::WOOD) == 0;
-  warning[int(Warning::DIGGING)] = mySquares.at(SquareType::FLOOR).empty();
+  warning[int(Warning::DIGGING)] = getSquares(SquareType::FLOOR).empty();
   warning[int(Warning::MINIONS)] = getNumMinions() <= 1;
   for (auto elem : taskInfo)
-    if (!mySquares.at(elem.second.square).empty())
+    if (!getSquares(elem.second.square).empty())
       warning[int(elem.second.warning)] = false;
   warning[int(Warning::NO_WEAPONS)] = false;
   for (Creature* c : minions) {
     PItem genWeapon = ItemFactory::fromId(ItemId::SWORD);
-    if (usesEquipment(c) && c->equip(genWeapon.get()) && getAllItems([&](const Item* it) {
-          return minionEquipment.canTakeItem(c, it); }, false).empty())
+    if (usesEquipment(c) && c->equip(genWeapon.get()) && !hasItemOnTerritory([&](const Item* it) {
+          return minionEquipment.canTakeItem(c, it); }))
       warning[int(Warning::NO_WEAPONS)] = true;
   }
 
-  map<Vec2, int> extendedTiles;
-  queue<Vec2> extendedQueue;
-  vector<Vec2> enemyPos;
-  for (Vec2 pos : myTiles) {
-    if (Creature* c = level->getSquare(pos)->getCreature()) {
-      if (c->getTribe() != tribe)
-        enemyPos.push_back(c->getPosition());
-    }
-    for (Vec2 v : pos.neighbors8())
-      if (v.inRectangle(level->getBounds()) && !myTiles.count(v) && !extendedTiles.count(v) 
-          && level->getSquare(v)->canEnterEmpty(Creature::getDefault())) {
-        extendedTiles[v] = 1;
-        extendedQueue.push(v);
-      }
-  }
   for (const Creature* c1 : getVisibleFriends()) {
     Creature* c = const_cast<Creature*>(c1);
     if (c->getName() != "boulder" && !contains(creatures, c))
       addCreature(c, MinionType::NORMAL);
   }
-  const int maxRadius = 10;
-  while (!extendedQueue.empty()) {
-    Vec2 pos = extendedQueue.front();
-    extendedQueue.pop();
-    if (Creature* c = level->getSquare(pos)->getCreature())
-      if (c->getTribe() != tribe)
-        enemyPos.push_back(c->getPosition());
-    for (Vec2 v : pos.neighbors8())
-      if (v.inRectangle(level->getBounds()) && !myTiles.count(v) && !extendedTiles.count(v) 
-          && level->getSquare(v)->canEnterEmpty(Creature::getDefault())) {
-        int a = extendedTiles[v] = extendedTiles[pos] + 1;
-        if (a < maxRadius)
-          extendedQueue.push(v);
-      }
-
-  }
+  vector<Vec2> enemyPos = getIntruderPositions();
   if (!enemyPos.empty())
     delayDangerousTasks(enemyPos, getTime() + 20);
   else
@@ -1960,7 +2225,7 @@ void Collective::tick() {
       if (elem.second.state == PrisonerInfo::SURRENDER) {
         Creature* c = elem.first;
         Vec2 pos = c->getPosition();
-        if (myTiles.count(pos) && !c->isDead()) {
+        if (myTiles.contains(pos) && !c->isDead()) {
           level->globalMessage(pos, c->getTheName() + " surrenders.");
           c->die(nullptr, true, false);
           addCreature(CreatureFactory::fromId(
@@ -1970,51 +2235,173 @@ void Collective::tick() {
       }
   }
   updateConstructions();
-  for (ItemFetchInfo elem : getFetchInfo()) {
-    for (Vec2 pos : myTiles)
-      fetchItems(pos, elem);
-    for (SquareType type : elem.additionalPos)
-      for (Vec2 pos : mySquares.at(type))
-        fetchItems(pos, elem);
+  updateHauling();
+  assignImpTasks();
+}
+
+void Collective::assignImpTasks() {
+  vector<Creature*> idle;
+  for (Creature* c : minionByType.at(MinionType::IMP))
+    if (c->getLevel() == level && !taskMap.getTask(c))
+      idle.push_back(c);
+  // a single imp is served just as well by TaskMap::getTaskForImp
+  if (idle.size() < 2)
+    return;
+  unordered_map<Vec2, vector<Task*>> openTasks;
+  int numOpen = 0;
+  for (Task* task : taskMap.getOpenTasks()) {
+    openTasks[task->getPosition()].push_back(task);
+    ++numOpen;
+  }
+  if (numOpen == 0)
+    return;
+  if (impDistance.getWidth() != level->getBounds().getW()
+      || impDistance.getHeight() != level->getBounds().getH()) {
+    impDistance = Table<int>(level->getBounds(), -1);
+    impSource = Table<int>(level->getBounds(), -1);
+  }
+  typedef tuple<int, UniqueId, Task*, int> Candidate; // distance, task id, task, imp index
+  priority_queue<Candidate, vector<Candidate>, std::greater<Candidate>> candidates;
+  vector<Vec2> visited;
+  queue<Vec2> q;
+  int numReached = 0;
+  auto visit = [&](Vec2 pos, int dist, int source) {
+    impDistance[pos] = dist;
+    impSource[pos] = source;
+    visited.push_back(pos);
+    if (openTasks.count(pos))
+      for (Task* task : openTasks.at(pos)) {
+        candidates.push(Candidate(dist, task->getUniqueId(), task, source));
+        ++numReached;
+      }
+  };
+  // one search from all idle imps at once, every square remembers the closest imp
+  for (int i : All(idle))
+    if (impDistance[idle[i]->getPosition()] == -1) {
+      visit(idle[i]->getPosition(), 0, i);
+      q.push(idle[i]->getPosition());
+    }
+  while (!q.empty() && numReached < numOpen) {
+    Vec2 pos = q.front();
+    q.pop();
+    for (Vec2 v : pos.neighbors8())
+      if (v.inRectangle(level->getBounds()) && impDistance[v] == -1) {
+        bool canEnter = level->getSquare(v)->canEnterEmpty(idle[impSource[pos]]);
+        if (canEnter || openTasks.count(v)) {
+          visit(v, impDistance[pos] + 1, impSource[pos]);
+          if (canEnter)
+            q.push(v);
+        }
+      }
+  }
+  for (Vec2 v : visited)
+    impDistance[v] = -1;
+  vector<bool> assigned(idle.size(), false);
+  unordered_set<Task*> assignedTasks;
+  int numAssigned = 0;
+  while (!candidates.empty() && numAssigned < idle.size()) {
+    int dist = get<0>(candidates.top());
+    Task* task = get<2>(candidates.top());
+    int imp = get<3>(candidates.top());
+    candidates.pop();
+    if (assignedTasks.count(task))
+      continue;
+    if (!assigned[imp] && !taskMap.isLocked(idle[imp], task)) {
+      if (task->getMove(idle[imp])) {
+        taskMap.takeTask(idle[imp], task);
+        assigned[imp] = true;
+        assignedTasks.insert(task);
+        ++numAssigned;
+        continue;
+      } else
+        taskMap.lock(idle[imp], task);
+    }
+    // the closest imp is busy or can't do the task, so offer it to the closest free one
+    int best = -1;
+    for (int i : All(idle))
+      if (!assigned[i] && !taskMap.isLocked(idle[i], task) && (best == -1 ||
+            task->getPosition().dist8(idle[i]->getPosition())
+                < task->getPosition().dist8(idle[best]->getPosition())))
+        best = i;
+    if (best > -1)
+      candidates.push(Candidate(max(dist, task->getPosition().dist8(idle[best]->getPosition())),
+            task->getUniqueId(), task, best));
   }
 }
 
-static Vec2 chooseRandomClose(Vec2 start, const set<Vec2>& squares) {
+static Vec2 chooseRandomClose(Vec2 start, const TileSet& squares) {
   int minD = 10000;
   int margin = 5;
-  int a;
-  vector<Vec2> close;
-  for (Vec2 v : squares)
-    if ((a = v.dist8(start)) < minD)
-      minD = a;
-  for (Vec2 v : squares)
-    if (v.dist8(start) < minD + margin)
-      close.push_back(v);
+  vector<pair<int, Vec2>> close;
+  for (Vec2 v : squares) {
+    int dist = v.dist8(start);
+    if (dist < minD + margin) {
+      close.emplace_back(dist, v);
+      minD = min(minD, dist);
+    }
+  }
   CHECK(!close.empty());
-  return chooseRandom(close);
+  vector<Vec2> ret;
+  for (auto& elem : close)
+    if (elem.first < minD + margin)
+      ret.push_back(elem.second);
+  return chooseRandom(ret);
 }
 
-void Collective::fetchItems(Vec2 pos, ItemFetchInfo elem) {
-  if (isDelayed(pos) || (traps.count(pos) && traps.at(pos).type == TrapType::BOULDER && traps.at(pos).armed == true))
-    return;
-  vector<Item*> equipment = level->getSquare(pos)->getItems(elem.predicate);
-  if (mySquares[elem.destination].count(pos))
-    return;
-  if (!equipment.empty()) {
-    if (mySquares[elem.destination].empty())
-      warning[int(elem.warning)] = true;
-    else {
-      warning[int(elem.warning)] = false;
-      if (elem.oneAtATime)
-        equipment = {equipment[0]};
-      Vec2 target = chooseRandomClose(pos, mySquares[elem.destination]);
-      taskMap.addTask(Task::bringItem(this, pos, equipment, target));
-      for (Item* it : equipment)
-        markItem(it);
+void Collective::addHaulingPos(Vec2 pos) {
+  if (haulingQueueValid)
+    haulingQueue.insert(pos);
+}
+
+void Collective::updateHauling() {
+  if (!haulingQueueValid) {
+    haulingQueue = TileSet(level->getBounds());
+    for (Vec2 pos : myTiles)
+      haulingQueue.insert(pos);
+    for (ItemFetchInfo elem : getFetchInfo())
+      for (SquareType type : elem.additionalPos)
+        for (Vec2 pos : getSquares(type))
+          haulingQueue.insert(pos);
+    haulingQueueValid = true;
+  }
+  vector<ItemFetchInfo> fetchInfo = getFetchInfo();
+  for (Vec2 pos : copyThis(haulingQueue.getAll())) {
+    bool pending = false;
+    for (ItemFetchInfo& elem : fetchInfo) {
+      bool applies = myTiles.contains(pos);
+      for (SquareType type : elem.additionalPos)
+        applies |= getSquares(type).contains(pos);
+      if (applies && fetchItems(pos, elem))
+        pending = true;
     }
+    if (!pending)
+      haulingQueue.erase(pos);
   }
 }
 
+bool Collective::fetchItems(Vec2 pos, ItemFetchInfo elem) {
+  if (getSquares(elem.destination).contains(pos))
+    return false;
+  vector<Item*> equipment = level->getSquare(pos)->getItems(elem.predicate);
+  if (equipment.empty())
+    return false;
+  if (isDelayed(pos) || (traps.count(pos) && traps.at(pos).type == TrapType::BOULDER && traps.at(pos).armed == true))
+    return true;
+  if (getSquares(elem.destination).empty()) {
+    warning[int(elem.warning)] = true;
+    return true;
+  }
+  warning[int(elem.warning)] = false;
+  if (elem.oneAtATime)
+    equipment = {equipment[0]};
+  Vec2 target = chooseRandomClose(pos, getSquares(elem.destination));
+  taskMap.addTask(Task::bringItem(this, pos, equipment, target));
+  for (Item* it : equipment)
+    markItem(it);
+  // the remaining items are fetched on the next turn
+  return elem.oneAtATime && level->getSquare(pos)->getItems(elem.predicate).size() > 0;
+}
+
 bool Collective::canSee(const Creature* c) const {
   return canSee(c->getPosition());
 }
@@ -2039,6 +2426,12 @@ bool Collective::isEnemy(const Creature* c) const {
   return keeper->isEnemy(c);
 }
 
+vector<EventId> Collective::getSubscribedEvents() const {
+  return {EventId::KILL, EventId::COMBAT, EventId::TRIGGER, EventId::SQUARE_REPLACED, EventId::CHANGE_LEVEL,
+      EventId::ALARM, EventId::TECH_BOOK, EventId::EQUIP, EventId::PICKUP, EventId::SURRENDER, EventId::TORTURE,
+      EventId::MOVE, EventId::ITEMS_CHANGED, EventId::DIFFICULTY_CHANGED};
+}
+
 void Collective::onChangeLevelEvent(const Creature* c, const Level* from, Vec2 pos, const Level* to, Vec2 toPos) {
   if (c == possessed) { 
     teamLevelChanges[from] = pos;
@@ -2108,14 +2501,14 @@ void Collective::onTortureEvent(Creature* who, const Creature* torturer) {
 }
 
 MoveInfo Collective::getBeastMove(Creature* c) {
-  if (!Random.roll(2) && !myTiles.count(c->getPosition()))
+  if (!Random.roll(2) && !myTiles.contains(c->getPosition()))
     return NoMove;
   if (auto action = c->continueMoving())
     return {1.0, action};
   if (!Random.roll(5))
     return NoMove;
   if (!borderTiles.empty())
-    if (auto action = c->moveTowards(chooseRandom(borderTiles)))
+    if (auto action = c->moveTowards(borderTiles.getRandom()))
       return {1.0, action};
   return NoMove;
 }
@@ -2179,7 +2572,7 @@ MoveInfo Collective::getAlarmMove(Creature* c) {
 }
 
 MoveInfo Collective::getDropItems(Creature *c) {
-  if (myTiles.count(c->getPosition())) {
+  if (myTiles.contains(c->getPosition())) {
     vector<Item*> items = c->getEquipment().getItems([this, c](const Item* item) {
         return minionEquipment.isItemUseful(item) && minionEquipment.getOwner(item) != c; });
     if (!items.empty() && c->drop(items))
@@ -2241,7 +2634,7 @@ MoveInfo Collective::getMinionMove(Creature* c) {
   if (usesEquipment(c))
     autoEquipment(c);
   if (c != keeper || !underAttack())
-    for (Vec2 v : mySquares[SquareType::STOCKPILE])
+    for (Vec2 v : getSquares(SquareType::STOCKPILE))
       for (Item* it : level->getSquare(v)->getItems([this, c] (const Item* it) {
             return minionEquipment.getOwner(it) == c; })) {
         PTask t;
@@ -2261,17 +2654,17 @@ MoveInfo Collective::getMinionMove(Creature* c) {
         minionTasks.at(c->getUniqueId()).setState(t);
         break;
       }
-  if (c == keeper && !myTiles.empty() && !myTiles.count(c->getPosition()))
-    if (auto action = c->moveTowards(chooseRandom(myTiles)))
+  if (c == keeper && !myTiles.empty() && !myTiles.contains(c->getPosition()))
+    if (auto action = c->moveTowards(myTiles.getRandom()))
       return {1.0, action};
   MinionTaskInfo info = taskInfo.at(minionTasks.at(c->getUniqueId()).getState());
-  if (mySquares[info.square].empty()) {
+  if (getSquares(info.square).empty()) {
     minionTasks.at(c->getUniqueId()).updateToNext();
     warning[int(info.warning)] = true;
     return NoMove;
   }
   warning[int(info.warning)] = false;
-  taskMap.addTask(Task::applySquare(this, mySquares[info.square]), c);
+  taskMap.addTask(Task::applySquare(this, getSquares(info.square).getAll()), c);
   minionTaskStrings[c->getUniqueId()] = info.desc;
   return taskMap.getTask(c)->getMove(c);
 }
@@ -2284,24 +2677,102 @@ bool Collective::underAttack() const {
   return false;
 }
 
+const int taskBucketSize = 8;
+
+Vec2 Collective::TaskMap::getBucket(Vec2 pos) {
+  auto divide = [](int a) { return a >= 0 ? a / taskBucketSize : (a + 1) / taskBucketSize - 1; };
+  return Vec2(divide(pos.x), divide(pos.y));
+}
+
+int Collective::TaskMap::getBucketDist(Vec2 pos, Vec2 bucket) {
+  Vec2 corner = bucket * taskBucketSize;
+  int dx = max(0, max(corner.x - pos.x, pos.x - corner.x - taskBucketSize + 1));
+  int dy = max(0, max(corner.y - pos.y, pos.y - corner.y - taskBucketSize + 1));
+  return max(dx, dy);
+}
+
+void Collective::TaskMap::indexTask(Task* task) {
+  Vec2 pos = task->getPosition();
+  if (indexedPos.count(task)) {
+    if (indexedPos.at(task) == pos)
+      return;
+    unindexTask(task);
+  }
+  indexedPos[task] = pos;
+  buckets[getBucket(pos)].push_back(task);
+}
+
+void Collective::TaskMap::unindexTask(Task* task) {
+  if (!indexedPos.count(task))
+    return;
+  Vec2 bucket = getBucket(indexedPos.at(task));
+  removeElement(buckets.at(bucket), task);
+  if (buckets.at(bucket).empty())
+    buckets.erase(bucket);
+  indexedPos.erase(task);
+}
+
+void Collective::TaskMap::updateIndex() {
+  if (!indexValid) {
+    buckets.clear();
+    indexedPos.clear();
+    for (PTask& task : tasks)
+      indexTask(task.get());
+    indexValid = true;
+  }
+  // tasks move only while they are being carried out
+  for (auto& elem : taken)
+    indexTask(elem.first);
+}
+
+vector<Task*> Collective::TaskMap::getOpenTasks() const {
+  vector<Task*> ret;
+  for (const PTask& task : tasks)
+    if (!taken.count(task.get()) && !delayedTasks.count(task->getUniqueId()))
+      ret.push_back(task.get());
+  return ret;
+}
+
+bool Collective::TaskMap::canTakeTask(const Creature* c, Task* task, int dist) const {
+  return (!taken.count(task) || (task->canTransfer()
+          && (task->getPosition() - taken.at(task)->getPosition()).length8() > dist))
+      && !isLocked(c, task)
+      && !delayedTasks.count(task->getUniqueId());
+}
+
 Task* Collective::TaskMap::getTaskForImp(Creature* c) {
-  Task* closest = nullptr;
-  for (PTask& task : tasks) {
-    double dist = (task->getPosition() - c->getPosition()).length8();
-    if ((!taken.count(task.get()) || (task->canTransfer() 
-                                && (task->getPosition() - taken.at(task.get())->getPosition()).length8() > dist))
-        && (!closest ||
-           dist < (closest->getPosition() - c->getPosition()).length8())
-        && !isLocked(c, task.get())
-        && (!delayedTasks.count(task->getUniqueId()) || delayedTasks.at(task->getUniqueId()) < c->getTime())) {
+  updateIndex();
+  Vec2 pos = c->getPosition();
+  vector<pair<int, Vec2>> bucketOrder;
+  for (auto& elem : buckets)
+    bucketOrder.emplace_back(getBucketDist(pos, elem.first), elem.first);
+  sort(bucketOrder.begin(), bucketOrder.end());
+  typedef tuple<int, UniqueId, Task*> Candidate;
+  priority_queue<Candidate, vector<Candidate>, std::greater<Candidate>> candidates;
+  int nextBucket = 0;
+  while (1) {
+    // only open buckets that can hold a task closer than the best candidate so far
+    while (nextBucket < bucketOrder.size()
+        && (candidates.empty() || get<0>(candidates.top()) > bucketOrder[nextBucket].first)) {
+      for (Task* task : buckets.at(bucketOrder[nextBucket].second))
+        candidates.push(Candidate(task->getPosition().dist8(pos), task->getUniqueId(), task));
+      ++nextBucket;
+    }
+    if (candidates.empty())
+      return nullptr;
+    int dist = get<0>(candidates.top());
+    Task* task = get<2>(candidates.top());
+    candidates.pop();
+    if (canTakeTask(c, task, dist)) {
       bool valid = task->getMove(c);
+      indexTask(task);
       if (valid)
-        closest = task.get();
+        return task;
       else
-        lock(c, task.get());
+        // the failure is remembered until the terrain changes
+        lock(c, task);
     }
   }
-  return closest;
 }
 
 MoveInfo Collective::getMove(Creature* c) {
@@ -2318,6 +2789,7 @@ MoveInfo Collective::getMove(Creature* c) {
   if (Task* task = taskMap.getTask(c)) {
     if (task->isDone()) {
       taskMap.removeTask(task);
+      LOG << "Imp task completed at " << getTime();
     } else
       return task->getMove(c);
   }
@@ -2325,7 +2797,7 @@ MoveInfo Collective::getMove(Creature* c) {
     taskMap.takeTask(c, closest);
     return closest->getMove(c);
   } else {
-    if (!myTiles.count(c->getPosition()) && keeper->getLevel() == c->getLevel()) {
+    if (!myTiles.contains(c->getPosition()) && keeper->getLevel() == c->getLevel()) {
       Vec2 keeperPos = keeper->getPosition();
       if (keeperPos.dist8(c->getPosition()) < 3)
         return NoMove;
@@ -2414,6 +2886,7 @@ void Collective::addCreature(Creature* c, MinionType type) {
   minionByType[type].push_back(c);
   if (!contains({MinionType::IMP}, type)) {
     minions.push_back(c);
+    minionPowerValid = false;
     for (Technology* t : technologies)
       if (Skill* skill = t->getSkill())
         c->addSkill(skill);
@@ -2429,8 +2902,12 @@ void Collective::addCreature(Creature* c, MinionType type) {
 // actually only called when square is destroyed
 void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
   if (l == level) {
+    dangerZoneDirty = true;
+    taskMap.clearAllLocked();
+    if (itemIndexValid && myTiles.contains(pos))
+      dirtyItemPositions.insert(pos);
     for (auto& elem : mySquares)
-      if (elem.second.count(pos)) {
+      if (elem.second.contains(pos)) {
         elem.second.erase(pos);
       }
     if (constructions.count(pos)) {
@@ -2438,6 +2915,7 @@ void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
       info.marked = getTime() + 10; // wait a little before considering rebuilding
       info.built = false;
       info.task = -1;
+      scheduleConstruction(pos);
     }
     sectors->add(pos);
     flyingSectors->add(pos);
@@ -2447,6 +2925,7 @@ void Collective::onSquareReplacedEvent(const Level* l, Vec2 pos) {
 void Collective::onTriggerEvent(const Level* l, Vec2 pos) {
   if (traps.count(pos) && l == level) {
     traps.at(pos).armed = false;
+    scheduleTrap(pos);
     if (traps.at(pos).type == TrapType::SURPRISE)
       handleSurprise(pos);
   }
@@ -2495,6 +2974,14 @@ bool Collective::isInCombat(const Creature* c) const {
 void Collective::TaskMap::freeTaskDelay(Task* t, double d) {
   freeTask(t);
   delayedTasks[t->getUniqueId()] = d;
+  delayTimeouts.schedule(d, t->getUniqueId());
+}
+
+void Collective::TaskMap::releaseDelayedTasks(double time) {
+  for (UniqueId id : delayTimeouts.popDue(time))
+    // the task might have been delayed again in the meantime
+    if (delayedTasks.count(id) && delayedTasks.at(id) < time)
+      delayedTasks.erase(id);
 }
 
 void Collective::onKillEvent(const Creature* victim, const Creature* killer) {
@@ -2520,15 +3007,17 @@ void Collective::onKillEvent(const Creature* victim, const Creature* killer) {
       } else
         taskMap.freeTaskDelay(task, getTime() + 50);
     }
-    if (contains(minions, c))
+    if (contains(minions, c)) {
       removeElement(minions, c);
+      minionPowerValid = false;
+    }
     removeElement(minionByType.at(getMinionType(c)), c);
   } else if (victim->getTribe() != tribe && (!killer || killer->getTribe() == tribe)) {
     double incMana = victim->getDifficultyPoints() / 3;
     mana += incMana;
     kills.push_back(victim);
     points += victim->getDifficultyPoints();
-    Debug() << "Mana increase " << incMana << " from " << victim->getName();
+    LOG << "Mana increase " << incMana << " from " << victim->getName();
     keeper->increaseExpLevel(double(victim->getDifficultyPoints()) / 200);
   }
 }
@@ -25,6 +25,8 @@
 #include "task.h"
 #include "entity_set.h"
 #include "sectors.h"
+#include "tile_set.h"
+#include "delay_map.h"
 
 enum class MinionType {
   IMP,
@@ -57,6 +59,7 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
 
   virtual bool staticPosition() const override;
 
+  virtual vector<EventId> getSubscribedEvents() const override;
   virtual void onKillEvent(const Creature* victim, const Creature* killer) override;
   virtual void onCombatEvent(const Creature*) override;
   virtual void onTriggerEvent(const Level*, Vec2 pos) override;
@@ -68,6 +71,9 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   virtual void onPickupEvent(const Creature* c, const vector<Item*>& items);
   virtual void onSurrenderEvent(Creature* who, const Creature* to);
   virtual void onTortureEvent(Creature* who, const Creature* torturer);
+  virtual void onMoveEvent(const Creature*) override;
+  virtual void onItemsChangedEvent(const Level*, Vec2 pos) override;
+  virtual void onDifficultyChangedEvent(const Creature*) override;
 
   void onConqueredLand(const string& name);
 
@@ -165,6 +171,12 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   template <class Archive>
   static void registerTypes(Archive& ar);
 
+  /** Pops the positions that are due in \paramname{queue} at \paramname{time}. Positions for which
+      \paramname{getMarked} returns a negative number or a later time are dropped, as they were either
+      finished or scheduled again. Delayed positions are scheduled again for the end of their delay.*/
+  static vector<Vec2> popDuePositions(TimerWheel<Vec2>& queue, double time, const DelayMap& delays,
+      function<double(Vec2)> getMarked);
+
   private:
   Creature* addCreature(PCreature c, Vec2 v, MinionType);
   Creature* getCreature(UniqueId id);
@@ -226,7 +238,9 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   };
 
   vector<ItemFetchInfo> getFetchInfo() const;
-  void fetchItems(Vec2 pos, ItemFetchInfo);
+  bool fetchItems(Vec2 pos, ItemFetchInfo);
+  void updateHauling();
+  void addHaulingPos(Vec2 pos);
 
   vector<Technology*> SERIAL(technologies);
   bool hasTech(TechId id) const;
@@ -253,10 +267,15 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   MoveInfo getDropItems(Creature *c);
 
   bool isDownstairsVisible() const;
+  /** Recomputes the tiles within walking distance from the territory, in which hostile creatures are intruders.*/
+  void updateDangerZone();
+  bool isInDangerZone(Vec2) const;
+  vector<Vec2> getIntruderPositions();
   void delayDangerousTasks(const vector<Vec2>& enemyPos, double delayTime);
   bool isDelayed(Vec2 pos);
   double getTime() const;
-  unordered_map<Vec2, double> SERIAL(delayedPos);
+  DelayMap SERIAL(delayedPos);
+  Table<int> dangerDistance;
   int numGold(ResourceId) const;
   bool hasGold(CostInfo) const;
   void takeGold(CostInfo);
@@ -268,6 +287,14 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   void handleMarket(View*, int prevItem = 0);
   void getEquipmentItem(View* view, ItemPredicate predicate);
   vector<Item*> getAllItems(ItemPredicate predicate, bool includeMinions = true) const;
+  vector<Item*> getAllItems(ItemType, ItemPredicate predicate, bool includeMinions = true) const;
+  bool hasItemOnTerritory(ItemPredicate predicate) const;
+  /** Returns the tiles of the territory that hold items of the given type.*/
+  const vector<Vec2>& getItemPositions(ItemType) const;
+  vector<Item*> sortedWithMinionItems(vector<Item*>, ItemPredicate, bool includeMinions) const;
+  /** Returns the territory items of the given type, sorted by value.*/
+  const vector<Item*>& getSortedItems(ItemType) const;
+  void updateItemIndex() const;
   Item* chooseEquipmentItem(View* view, Item* currentItem, ItemPredicate predicate,
       int* index = nullptr, double* scrollPos = nullptr) const;
   bool usesEquipment(const Creature* c) const;
@@ -300,7 +327,7 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   bool tryLockingDoor(Vec2 pos);
   void addKnownTile(Vec2 pos);
 
-  vector<pair<Item*, Vec2>> getTrapItems(TrapType, set<Vec2> = {}) const;
+  vector<pair<Item*, Vec2>> getTrapItems(TrapType, bool onlyWorkshops = true) const;
   ItemPredicate unMarkedItems(ItemType) const;
   MarkovChain<MinionTask> getTasksForMinion(Creature* c);
   vector<Creature*> SERIAL(creatures);
@@ -310,6 +337,7 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
 
   class TaskMap : public Task::Mapping {
     public:
+    Task* addTask(PTask, const Creature* = nullptr);
     Task* addTaskCost(PTask, CostInfo);
     void markSquare(Vec2 pos, PTask);
     void unmarkSquare(Vec2 pos);
@@ -320,7 +348,9 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
     void lock(const Creature*, const Task*);
     void clearAllLocked();
     Task* getTaskForImp(Creature*);
+    vector<Task*> getOpenTasks() const;
     void freeTaskDelay(Task*, double delayTime);
+    void releaseDelayedTasks(double time);
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int version);
@@ -328,10 +358,20 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
     SERIAL_CHECKER;
 
     private:
+    bool canTakeTask(const Creature*, Task*, int dist) const;
+    void updateIndex();
+    void indexTask(Task*);
+    void unindexTask(Task*);
+    static Vec2 getBucket(Vec2 pos);
+    static int getBucketDist(Vec2 pos, Vec2 bucket);
     map<Vec2, Task*> SERIAL(marked);
     map<Task*, CostInfo> SERIAL(completionCost);
-    set<pair<const Creature*, UniqueId>> SERIAL(lockedTasks);
+    unordered_set<pair<const Creature*, UniqueId>, PairHash> SERIAL(lockedTasks);
+    map<Vec2, vector<Task*>> buckets;
+    unordered_map<Task*, Vec2> indexedPos;
+    bool indexValid = false;
     map<UniqueId, double> SERIAL(delayedTasks);
+    TimerWheel<UniqueId> SERIAL(delayTimeouts);
   } SERIAL(taskMap);
 
   struct TrapInfo {
@@ -343,6 +383,8 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   };
   map<Vec2, TrapInfo> SERIAL(traps);
   set<TrapType> getNeededTraps() const;
+  void scheduleTrap(Vec2 pos);
+  void updateTraps();
 
   struct ConstructionInfo {
     CostInfo cost;
@@ -356,15 +398,24 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   void setMinionTask(Creature* c, MinionTask task);
   MinionTask getMinionTask(Creature* c) const;
   map<Vec2, ConstructionInfo> SERIAL(constructions);
+  void scheduleConstruction(Vec2 pos);
+  void updateDueQueues();
+  TimerWheel<Vec2> constructionQueue;
+  TimerWheel<Vec2> trapQueue;
+  map<ResourceId, set<pair<int, Vec2>>> waitingForResource;
+  map<TrapType, set<Vec2>> waitingForTrapItem;
+  bool dueQueuesValid = false;
   map<UniqueId, MarkovChain<MinionTask>> SERIAL(minionTasks);
   map<UniqueId, string> SERIAL(minionTaskStrings);
-  map<SquareType, set<Vec2>> SERIAL(mySquares);
-  set<Vec2> SERIAL(myTiles);
+  TileSet& getSquares(SquareType);
+  const TileSet& getSquares(SquareType) const;
+  map<SquareType, TileSet> SERIAL(mySquares);
+  TileSet SERIAL(myTiles);
   Level* SERIAL(level);
   Creature* SERIAL2(keeper, nullptr);
   mutable unique_ptr<map<Level*, MapMemory>> SERIAL(memory);
   Table<bool> SERIAL(knownTiles);
-  set<Vec2> SERIAL(borderTiles);
+  TileSet SERIAL(borderTiles);
   bool SERIAL2(gatheringTeam, false);
   vector<Creature*> SERIAL(team);
   map<const Level*, Vec2> SERIAL(teamLevelChanges);
@@ -406,6 +457,27 @@ class Collective : public CreatureView, public EventListener, public Task::Callb
   unique_ptr<Sectors> SERIAL(sectors);
   unique_ptr<Sectors> SERIAL(flyingSectors);
   unordered_set<Vec2> SERIAL(surprises);
+  void assignImpTasks();
+  Table<int> impDistance;
+  Table<int> impSource;
+  Table<int> dangerZone;
+  bool dangerZoneDirty = true;
+  unordered_set<const Creature*> intruders;
+  mutable map<ItemType, TileSet> itemPositions;
+  mutable map<ItemType, vector<Item*>> sortedItems;
+  // types whose items changed since sortedItems was built
+  mutable set<ItemType> unsortedTypes;
+  mutable map<TrapType, TileSet> trapItemPositions;
+  // trap types whose items might have become available since the last updateTraps
+  mutable set<TrapType> trapItemsChanged;
+  mutable TileSet dirtyItemPositions;
+  mutable bool itemIndexValid = false;
+  void updateMinionPower() const;
+  mutable unordered_map<const Creature*, int> minionPoints;
+  mutable double minionPower = 0;
+  mutable bool minionPowerValid = false;
+  TileSet haulingQueue;
+  bool haulingQueueValid = false;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "statistics.h"
 #include "options.h"
 #include "model.h"
+#include "profiler.h"
 
 template <class Archive> 
 void SpellInfo::serialize(Archive& ar, const unsigned int version) {
@@ -35,6 +36,14 @@ void SpellInfo::serialize(Archive& ar, const unsigned int version) {
 
 SERIALIZABLE(SpellInfo);
 
+template <class Archive> 
+void Creature::EffectTimeout::serialize(Archive& ar, const unsigned int version) {
+  ar& BOOST_SERIALIZATION_NVP(creature)
+    & BOOST_SERIALIZATION_NVP(effect);
+}
+
+SERIALIZABLE(Creature::EffectTimeout);
+
 
 template <class Archive> 
 void Creature::serialize(Archive& ar, const unsigned int version) { 
@@ -42,7 +51,6 @@ void Creature::serialize(Archive& ar, const unsigned int version) {
     & SUBCLASS(CreatureAttributes)
     & SUBCLASS(CreatureView)
     & SUBCLASS(UniqueEntity)
-    & SUBCLASS(EventListener)
     & SVAR(viewObject)
     & SVAR(level)
     & SVAR(position)
@@ -51,7 +59,7 @@ void Creature::serialize(Archive& ar, const unsigned int version) {
     & SVAR(shortestPath)
     & SVAR(knownHiding)
     & SVAR(tribe)
-    & SVAR(enemyChecks)
+    & SVAR(enemyCheck)
     & SVAR(health)
     & SVAR(dead)
     & SVAR(lastTick)
@@ -75,6 +83,9 @@ void Creature::serialize(Archive& ar, const unsigned int version) {
     & SVAR(sectors)
     & SVAR(numAttacksThisTurn);
   CHECK_SERIAL;
+  // a loaded creature gets a new slot, which it doesn't need if it's dead
+  if (dead)
+    freeSlot();
 }
 
 SERIALIZABLE(Creature);
@@ -82,11 +93,13 @@ SERIALIZABLE(Creature);
 PCreature Creature::defaultCreature;
 PCreature Creature::defaultFlyer;
 PCreature Creature::defaultMinion;
+TimerWheel<Creature::EffectTimeout> Creature::effectTimeouts;
 
 void Creature::initialize() {
   defaultCreature.reset();
   defaultFlyer.reset();
   defaultMinion.reset();
+  effectTimeouts.clear();
 }
 
 Creature* Creature::getDefault() {
@@ -122,17 +135,41 @@ Creature::Creature(Tribe* t, const CreatureAttributes& attr, ControllerFactory f
 
 Creature::~Creature() {
   tribe->removeMember(this);
+  freeSlot();
+}
+
+static int numSlots = 0;
+static vector<int> freeSlots;
+
+int Creature::takeSlot() {
+  if (freeSlots.empty())
+    return numSlots++;
+  int ret = freeSlots.back();
+  freeSlots.pop_back();
+  return ret;
+}
+
+void Creature::freeSlot() {
+  if (slot >= 0) {
+    freeSlots.push_back(slot);
+    slot = -1;
+  }
+}
+
+int Creature::getSlot() const {
+  return slot;
 }
 
 ViewIndex Creature::getViewIndex(Vec2 pos) const {
   return level->getSquare(pos)->getViewIndex(this);
 }
 
-Creature::Action::Action(function<void()> f) : action(f) {
+Creature::Action::Action(SmallFunction f) : numSteps(1) {
+  steps[0] = std::move(f);
 }
 
 Creature::Action::Action(const string& msg)
-    : action(nullptr), failedMessage(msg) {
+    : failedMessage(msg) {
 }
 
 #ifndef RELEASE
@@ -146,37 +183,38 @@ void Creature::Action::checkUsage(bool b) {
   usageCheck = b;
 }
 
-Creature::Action::Action(const Action& a) : action(a.action), before(a.before), after(a.after),
-  failedMessage(a.failedMessage), wasUsed(true) {
+Creature::Action::Action(const Action& a) : numSteps(a.numSteps), failedMessage(a.failedMessage), wasUsed(true) {
+  for (int i = 0; i < numSteps; ++i)
+    steps[i] = a.steps[i];
   a.wasUsed = true;
 }
 #endif
 
 void Creature::Action::perform() {
-  if (before)
-    before();
-  CHECK(action);
-  action();
-  if (after)
-    after();
+  CHECK(numSteps > 0);
+  for (int i = 0; i < numSteps; ++i)
+    steps[i]();
 #ifndef RELEASE
   wasUsed = true;
 #endif
 }
 
-Creature::Action Creature::Action::prepend(function<void()> f) {
-  if (!before)
-    before = f;
-  else
-    before = [=] { f(); before(); };
+Creature::Action Creature::Action::prepend(SmallFunction f) {
+  if (numSteps > 0) {
+    CHECK(numSteps < maxSteps) << "Too many steps chained to an action";
+    for (int i = numSteps; i > 0; --i)
+      steps[i] = std::move(steps[i - 1]);
+    steps[0] = std::move(f);
+    ++numSteps;
+  }
   return *this;
 }
 
-Creature::Action Creature::Action::append(function<void()> f) {
-  if (!after)
-    after = f;
-  else
-    after = [=] { after(); f(); };
+Creature::Action Creature::Action::append(SmallFunction f) {
+  if (numSteps > 0) {
+    CHECK(numSteps < maxSteps) << "Too many steps chained to an action";
+    steps[numSteps++] = std::move(f);
+  }
   return *this;
 }
 
@@ -188,7 +226,7 @@ Creature::Action::operator bool() const {
 #ifndef RELEASE
   wasUsed = true;
 #endif
-  return action != nullptr;
+  return numSteps > 0;
 }
 
 SpellInfo Creature::getSpell(SpellId id) {
@@ -289,7 +327,7 @@ Creature::Action Creature::move(Vec2 direction) {
     return Action("");
   return Action([=]() {
     stationary = false;
-    Debug() << getTheName() << " moving " << direction;
+    LOG << getTheName() << " moving " << direction;
     if (isAffected(ENTANGLED)) {
       playerMessage("You can't break free!");
       spendTime(1);
@@ -362,6 +400,7 @@ Creature::Action Creature::swapPosition(Vec2 direction, bool force) {
 
 void Creature::makeMove() {
   numAttacksThisTurn = 0;
+  invalidateStats();
   CHECK(!isDead());
   if (holding && holding->isDead())
     holding = nullptr;
@@ -377,7 +416,10 @@ void Creature::makeMove() {
   updateVisibleCreatures();
   if (swapPositionCooldown)
     --swapPositionCooldown;
-  MEASURE(controller->makeMove(), "creature move time");
+  {
+    PROFILE("creature move");
+    controller->makeMove();
+  }
   CHECK(!inEquipChain) << "Someone forgot to finishEquipChain()";
   if (!hidden)
     viewObject.removeModifier(ViewObject::HIDDEN);
@@ -406,7 +448,7 @@ const Square* Creature::getConstSquare(Vec2 direction) const {
 
 Creature::Action Creature::wait() {
   return Action([=]() {
-    Debug() << getTheName() << " waiting";
+    LOG << getTheName() << " waiting";
     bool keepHiding = hidden;
     spendTime(1);
     hidden = keepHiding;
@@ -500,7 +542,7 @@ Creature::Action Creature::pickUp(const vector<Item*>& items, bool spendT) {
   if (weight > 2 * getAttr(AttrType::INV_LIMIT))
     return Action("You are carrying too much to pick this up.");
   return Action([=]() {
-    Debug() << getTheName() << " pickup ";
+    LOG << getTheName() << " pickup ";
     if (spendT)
       for (auto elem : Item::stackItems(items)) {
         monsterMessage(getTheName() + " picks up " + elem.first);
@@ -521,7 +563,7 @@ Creature::Action Creature::drop(const vector<Item*>& items) {
   if (!isHumanoid())
     return Action("You can't drop this item!");
   return Action([=]() {
-    Debug() << getTheName() << " drop";
+    LOG << getTheName() << " drop";
     for (auto elem : Item::stackItems(items)) {
       monsterMessage(getTheName() + " drops " + elem.first);
       playerMessage("You drop " + elem.first);
@@ -589,10 +631,11 @@ Creature::Action Creature::equip(Item* item) {
   if (equipment.getItem(item->getEquipmentSlot()))
     return Action("This slot is already equiped.");
   return Action([=]() {
-    Debug() << getTheName() << " equip " << item->getName();
+    LOG << getTheName() << " equip " << item->getName();
     EquipmentSlot slot = item->getEquipmentSlot();
     equipment.equip(item, slot);
     item->onEquip(this);
+    updateDifficultyPoints();
     EventListener::addEquipEvent(this, item);
     if (!inEquipChain)
       spendTime(1);
@@ -609,11 +652,12 @@ Creature::Action Creature::unequip(Item* item) {
   if (numGood(BodyPart::ARM) == 0)
     return Action("You have no healthy arms!");
   return Action([=]() {
-    Debug() << getTheName() << " unequip";
+    LOG << getTheName() << " unequip";
     EquipmentSlot slot = item->getEquipmentSlot();
     CHECK(equipment.getItem(slot) == item) << "Item not equiped.";
     equipment.unequip(slot);
     item->onUnequip(this);
+    updateDifficultyPoints();
     if (!inEquipChain)
       spendTime(1);
     else
@@ -647,7 +691,7 @@ Creature::Action Creature::bumpInto(Vec2 direction) {
 Creature::Action Creature::applySquare() {
   if (getSquare()->getApplyType(this))
     return Action([=]() {
-      Debug() << getTheName() << " applying " << getSquare()->getName();;
+      LOG << getTheName() << " applying " << getSquare()->getName();;
       getSquare()->onApply(this);
       spendTime(1);
     });
@@ -824,12 +868,30 @@ void Creature::onTimedOut(LastingEffect effect, bool msg) {
 void Creature::addEffect(LastingEffect effect, double time, bool msg) {
   if (lastingEffects[effect] < getTime() + time && affects(effect)) {
     lastingEffects[effect] = getTime() + time;
+    invalidateStats();
+    effectTimeouts.schedule(lastingEffects[effect], {this, effect});
     onAffected(effect, msg);
+    updateDifficultyPoints();
+  }
+}
+
+void Creature::timeOutEffects(double time) {
+  for (EffectTimeout timeout : effectTimeouts.popDue(time)) {
+    Creature* c = timeout.creature;
+    // the effect might have been removed or extended since it was scheduled, effects of creatures
+    // on dormant levels time out in catchUp()
+    if (!c->isDead() && c->level->isActive()
+        && c->lastingEffects[timeout.effect] > 0 && c->lastingEffects[timeout.effect] < time) {
+      c->lastingEffects[timeout.effect] = 0;
+      c->invalidateStats();
+      c->onTimedOut(timeout.effect, true);
+    }
   }
 }
 
 void Creature::removeEffect(LastingEffect effect, bool msg) {
   lastingEffects[effect] = 0;
+  invalidateStats();
   onRemoved(effect, msg);
 }
 
@@ -876,7 +938,44 @@ int Creature::toHitBonus() const {
     return 0;
 }
 
+static const int numAttrTypes = int(AttrType::INV_LIMIT) + 1;
+
+void Creature::invalidateStats() const {
+  statCacheValid = false;
+}
+
+void Creature::onEquipmentModified() {
+  invalidateStats();
+  updateDifficultyPoints();
+}
+
+void Creature::updateStatCache() const {
+  if (statCacheValid && statCacheTime == getTime() && statCacheHandicap == tribe->getHandicap()
+      && statCacheVersion == equipment.getVersion())
+    return;
+  attrCache.assign(numAttrTypes, -1);
+  inventoryWeight = -1;
+  statCacheValid = true;
+  statCacheTime = getTime();
+  statCacheHandicap = tribe->getHandicap();
+  statCacheVersion = equipment.getVersion();
+}
+
 int Creature::getAttr(AttrType type) const {
+  updateStatCache();
+  int ret = attrCache[int(type)];
+  if (ret < 0) {
+    ret = computeAttr(type);
+    attrCache[int(type)] = ret;
+  }
+#ifdef DEBUG_STL
+  else
+    CHECKEQ(ret, computeAttr(type));
+#endif
+  return ret;
+}
+
+int Creature::computeAttr(AttrType type) const {
   int def = getAttrVal(type);
   for (Item* item : equipment.getItems())
     if (equipment.isEquiped(item))
@@ -959,16 +1058,14 @@ int Creature::getPoints() const {
   return points;
 }
 
-void Creature::onKillEvent(const Creature* victim, const Creature* killer) {
-  if (killer == this)
-    points += victim->getDifficultyPoints();
-}
-
 double Creature::getInventoryWeight() const {
-  double ret = 0;
-  for (Item* item : getEquipment().getItems())
-    ret += item->getWeight();
-  return ret;
+  updateStatCache();
+  if (inventoryWeight < 0) {
+    inventoryWeight = 0;
+    for (Item* item : getEquipment().getItems())
+      inventoryWeight += item->getWeight();
+  }
+  return inventoryWeight;
 }
 
 Tribe* Creature::getTribe() const {
@@ -982,24 +1079,26 @@ bool Creature::isFriend(const Creature* c) const {
 pair<double, double> Creature::getStanding(const Creature* c) const {
   double bestWeight = 0;
   double standing = getTribe()->getStanding(c);
-  if (contains(privateEnemies, c)) {
+  if (privateEnemies.count(c)) {
     standing = -1;
     bestWeight = 1;
   }
-  for (EnemyCheck* enemyCheck : enemyChecks)
-    if (enemyCheck->hasStanding(c) && enemyCheck->getWeight() > bestWeight) {
-      standing = enemyCheck->getStanding(c);
-      bestWeight = enemyCheck->getWeight();
-    }
+  if (enemyCheck && enemyCheck->getWeight() > bestWeight && enemyCheck->hasStanding(c)) {
+    standing = enemyCheck->getStanding(c);
+    bestWeight = enemyCheck->getWeight();
+  }
   return make_pair(standing, bestWeight);
 }
 
+// enemy checks come from amulets, so there is at most one
 void Creature::addEnemyCheck(EnemyCheck* c) {
-  enemyChecks.push_back(c);
+  CHECK(!enemyCheck);
+  enemyCheck = c;
 }
 
 void Creature::removeEnemyCheck(EnemyCheck* c) {
-  removeElement(enemyChecks, c);
+  CHECK(enemyCheck == c);
+  enemyCheck = nullptr;
 }
 
 bool Creature::isEnemy(const Creature* c) const {
@@ -1017,7 +1116,7 @@ bool Creature::isEnemy(const Creature* c) const {
 
 vector<Item*> Creature::getGold(int num) const {
   vector<Item*> ret;
-  for (Item* item : equipment.getItems([](Item* it) { return it->getType() == ItemType::GOLD; })) {
+  for (Item* item : equipment.getItems(ItemType::GOLD)) {
     ret.push_back(item);
     if (ret.size() == num)
       return ret;
@@ -1042,17 +1141,11 @@ void Creature::setTime(double t) {
 }
 
 void Creature::tick(double realTime) {
-  getDifficultyPoints();
   for (Item* item : equipment.getItems()) {
     item->tick(time, level, position);
     if (item->isDiscarded())
       equipment.removeItem(item);
   }
-  for (LastingEffect effect : ENUM_ALL(LastingEffect))
-    if (lastingEffects[effect] > 0 && lastingEffects[effect] < realTime) {
-      lastingEffects[effect] = 0;
-      onTimedOut(effect, true);
-    }
   if (isAffected(POISON)) {
     bleed(1.0 / 60);
     playerMessage("You feel poison flowing in your veins.");
@@ -1067,6 +1160,7 @@ void Creature::tick(double realTime) {
   }
   if (health < 0.5) {
     health -= delta / 40;
+    invalidateStats();
     playerMessage("You are bleeding.");
   }
   if (health <= 0) {
@@ -1076,6 +1170,19 @@ void Creature::tick(double realTime) {
 
 }
 
+void Creature::catchUp(double time) {
+  // the turn until time is left for tick()
+  double poisonEnd = min(lastingEffects[POISON], time - 1);
+  if (poisonEnd > lastTick)
+    bleed((poisonEnd - lastTick) / 60);
+  for (LastingEffect effect : ENUM_ALL(LastingEffect))
+    if (lastingEffects[effect] > 0 && lastingEffects[effect] < time) {
+      lastingEffects[effect] = 0;
+      invalidateStats();
+      onTimedOut(effect, false);
+    }
+}
+
 BodyPart Creature::armOrWing() const {
   if (numGood(BodyPart::ARM) == 0)
     return BodyPart::WING;
@@ -1146,6 +1253,7 @@ static string getBodyPartBone(BodyPart part) {
 void Creature::injureBodyPart(BodyPart part, bool drop) {
   if (bodyParts[part] == 0)
     return;
+  invalidateStats();
   if (drop) {
     if (contains({BodyPart::LEG, BodyPart::ARM, BodyPart::WING}, part))
       Statistics::add(StatId::CHOPPED_LIMB);
@@ -1207,7 +1315,7 @@ Creature::Action Creature::attack(const Creature* c1, Optional<AttackLevel> atta
   if (attackLevel1 && !contains(getAttackLevels(), *attackLevel1))
     return Action("Invalid attack level.");
   return Action([=] () {
-  Debug() << getTheName() << " attacking " << c->getName();
+  LOG << getTheName() << " attacking " << c->getName();
   int toHit =  getAttr(AttrType::TO_HIT);
   int damage = getAttr(AttrType::DAMAGE);
   int toHitVariance = 1 + toHit / 3;
@@ -1251,13 +1359,14 @@ Creature::Action Creature::attack(const Creature* c1, Optional<AttackLevel> atta
 
 bool Creature::dodgeAttack(const Attack& attack) {
   ++numAttacksThisTurn;
-  Debug() << getTheName() << " dodging " << attack.getAttacker()->getName() << " to hit " << attack.getToHit() << " dodge " << getAttr(AttrType::TO_HIT);
+  invalidateStats();
+  LOG << getTheName() << " dodging " << attack.getAttacker()->getName() << " to hit " << attack.getToHit() << " dodge " << getAttr(AttrType::TO_HIT);
   if (const Creature* c = attack.getAttacker()) {
     if (!canSee(c))
       unknownAttacker.push_back(c);
     EventListener::addAttackEvent(this, c);
-    if (!contains(privateEnemies, c) && c->getTribe() != tribe)
-      privateEnemies.push_back(c);
+    if (c->getTribe() != tribe)
+      privateEnemies.insert(c);
   }
   return canSee(attack.getAttacker()) && attack.getToHit() <= getAttr(AttrType::TO_HIT);
 }
@@ -1285,10 +1394,10 @@ bool Creature::takeDamage(const Attack& attack) {
   if (isAffected(SLEEP))
     removeEffect(SLEEP);
   if (const Creature* c = attack.getAttacker())
-    if (!contains(privateEnemies, c) && c->getTribe() != tribe)
-      privateEnemies.push_back(c);
+    if (c->getTribe() != tribe)
+      privateEnemies.insert(c);
   int defense = getAttr(AttrType::DEFENSE);
-  Debug() << getTheName() << " attacked by " << attack.getAttacker()->getName() << " damage " << attack.getStrength() << " defense " << defense;
+  LOG << getTheName() << " attacked by " << attack.getAttacker()->getName() << " damage " << attack.getStrength() << " defense " << defense;
   if (passiveAttack && attack.getAttacker() && attack.getAttacker()->getPosition().dist8(position) == 1) {
     Creature* other = const_cast<Creature*>(attack.getAttacker());
     Effect::applyToCreature(other, *passiveAttack, EffectStrength::NORMAL);
@@ -1313,8 +1422,10 @@ bool Creature::takeDamage(const Attack& attack) {
             die(attack.getAttacker());
             return true;
           }
-          if (health <= 0)
+          if (health <= 0) {
             health = 0.01;
+            invalidateStats();
+          }
           return false;
         }
       }
@@ -1450,6 +1561,8 @@ string Creature::getDescription() const {
 
 void Creature::setSpeed(double value) {
   speed = value;
+  invalidateStats();
+  updateDifficultyPoints();
 }
 
 double Creature::getSpeed() const {
@@ -1461,7 +1574,8 @@ CreatureSize Creature::getSize() const {
 }
 
 void Creature::heal(double amount, bool replaceLimbs) {
-  Debug() << getTheName() << " heal";
+  LOG << getTheName() << " heal";
+  invalidateStats();
   if (health < 1) {
     health = min(1., health + amount);
     if (health >= 0.5) {
@@ -1499,8 +1613,9 @@ void Creature::heal(double amount, bool replaceLimbs) {
 void Creature::bleed(double severity) {
   updateViewObject();
   health -= severity;
+  invalidateStats();
   updateViewObject();
-  Debug() << getTheName() << " health " << health;
+  LOG << getTheName() << " health " << health;
 }
 
 void Creature::setOnFire(double amount) {
@@ -1546,7 +1661,7 @@ void Creature::take(vector<PItem> items) {
 
 void Creature::take(PItem item) {
  /* item->identify();
-  Debug() << (specialMonster ? "special monster " : "") + getTheName() << " takes " << item->getNameAndModifiers();*/
+  LOG << (specialMonster ? "special monster " : "") + getTheName() << " takes " << item->getNameAndModifiers();*/
   if (item->isWieldedTwoHanded())
     addSkill(Skill::get(SkillId::TWO_HANDED_WEAPON));
   if (item->getType() == ItemType::RANGED_WEAPON)
@@ -1563,10 +1678,12 @@ void Creature::dropCorpse() {
 }
 
 void Creature::die(const Creature* attacker, bool dropInventory, bool dCorpse) {
-  Debug() << getTheName() << " dies. Killed by " << (attacker ? attacker->getName() : "");
+  LOG << getTheName() << " dies. Killed by " << (attacker ? attacker->getName() : "");
   controller->onKilled(attacker);
-  if (attacker)
+  if (attacker) {
     attacker->kills.push_back(this);
+    attacker->points += getDifficultyPoints();
+  }
   if (dropInventory)
     for (PItem& item : equipment.removeAllItems()) {
       getSquare()->dropItem(std::move(item));
@@ -1576,6 +1693,10 @@ void Creature::die(const Creature* attacker, bool dropInventory, bool dCorpse) {
     dropCorpse();
   level->killCreature(this);
   EventListener::addKillEvent(this, attacker);
+  for (Creature* c : level->getAllCreatures())
+    c->privateEnemies.erase(this);
+  privateEnemies.clear();
+  freeSlot();
   if (innocent)
     Statistics::add(StatId::INNOCENT_KILLED);
   Statistics::add(StatId::DEATH);
@@ -1585,10 +1706,11 @@ Creature::Action Creature::flyAway() {
   if (!canFly() || level->getCoverInfo(position).covered)
     return Action("");
   return Action([=]() {
-    Debug() << getTheName() << " fly away";
+    LOG << getTheName() << " fly away";
     monsterMessage(getTheName() + " flies away.");
     dead = true;
     level->killCreature(this);
+    freeSlot();
   });
 }
 
@@ -1897,6 +2019,8 @@ Gender Creature::getGender() const {
 
 void Creature::increaseExpLevel(double amount) {
   expLevel = min<double>(maxLevel, amount + expLevel);
+  invalidateStats();
+  updateDifficultyPoints();
   if (skillGain.count(getExpLevel()) && isHumanoid()) {
     you(MsgType::ARE, "more experienced");
     addSkill(skillGain.at(getExpLevel()));
@@ -1908,11 +2032,23 @@ int Creature::getExpLevel() const {
   return expLevel;
 }
 
+double Creature::getCurrentDifficultyPoints() const {
+  return getAttr(AttrType::DEFENSE) + getAttr(AttrType::TO_HIT) + getAttr(AttrType::DAMAGE)
+      + getAttr(AttrType::SPEED) / 10;
+}
+
 int Creature::getDifficultyPoints() const {
-  difficultyPoints = max<double>(difficultyPoints,
-      getAttr(AttrType::DEFENSE) + getAttr(AttrType::TO_HIT) + getAttr(AttrType::DAMAGE)
-      + getAttr(AttrType::SPEED) / 10);
-  return difficultyPoints;
+  return max(difficultyPoints, getCurrentDifficultyPoints());
+}
+
+void Creature::updateDifficultyPoints() {
+  double points = getCurrentDifficultyPoints();
+  if (points > difficultyPoints) {
+    bool changed = int(points) > int(difficultyPoints);
+    difficultyPoints = points;
+    if (changed)
+      EventListener::addDifficultyChangedEvent(this);
+  }
 }
 
 void Creature::addSectors(Sectors* s) {
@@ -1945,7 +2081,7 @@ Creature::Action Creature::moveTowards(Vec2 pos, bool away, bool stepOnTile) {
     if (!sectorOk)
       return Action("");
   }
-  Debug() << "" << getPosition() << (away ? "Moving away from" : " Moving toward ") << pos;
+  LOG << "" << getPosition() << (away ? "Moving away from" : " Moving toward ") << pos;
   bool newPath = false;
   bool targetChanged = shortestPath && shortestPath->getTarget().dist8(pos) > getPosition().dist8(pos) / 10;
   if (!shortestPath || targetChanged || shortestPath->isReversed() != away) {
@@ -1963,7 +2099,7 @@ Creature::Action Creature::moveTowards(Vec2 pos, bool away, bool stepOnTile) {
   }
   if (newPath)
     return Action("");
-  Debug() << "Reconstructing shortest path.";
+  LOG << "Reconstructing shortest path.";
   if (!away)
     shortestPath = ShortestPath(getLevel(), this, pos, getPosition());
   else
@@ -1972,7 +2108,7 @@ Creature::Action Creature::moveTowards(Vec2 pos, bool away, bool stepOnTile) {
     Vec2 pos2 = shortestPath->getNextMove(getPosition());
     return move(pos2 - getPosition());
   } else {
-    Debug() << "Cannot move toward " << pos;
+    LOG << "Cannot move toward " << pos;
     return Action("");
   }
 }
@@ -31,11 +31,12 @@
 #include "event.h"
 #include "sectors.h"
 #include "vision.h"
+#include "timer_wheel.h"
 
 class Level;
 class Tribe;
 
-class Creature : public CreatureAttributes, public CreatureView, public UniqueEntity, public EventListener {
+class Creature : public CreatureAttributes, public CreatureView, public UniqueEntity {
   public:
   typedef CreatureAttributes CreatureAttributes;
   Creature(Tribe* tribe, const CreatureAttributes& attr, ControllerFactory);
@@ -78,6 +79,10 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   virtual bool isEnemy(const Creature*) const override;
   void tick(double realTime);
 
+  /** Applies the poison for the turns spent on a dormant level, and times out the effects that ended
+      meanwhile. Used when a dormant level is woken up, before the creature ticks again.*/
+  void catchUp(double time);
+
   string getTheName() const;
   string getAName() const;
   string getName() const;
@@ -85,13 +90,17 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   string getNameAndTitle() const;
   Optional<string> getFirstName() const;
   int getAttr(AttrType) const;
+  /** Must be called after changing the modifiers of an equipped item in place.*/
+  void onEquipmentModified();
   int getPoints() const;
   vector<string> getMainAdjectives() const;
   vector<string> getAdjectives() const;
   Vision* getVision() const;
-  void onKillEvent(const Creature* victim, const Creature* killer) override;
 
   virtual Tribe* getTribe() const override;
+  /** Dense index of a living creature, for looking up per-creature data in arrays. Slots of dead creatures
+    are reused, so it's -1 once the creature is dead.*/
+  int getSlot() const;
   bool isFriend(const Creature*) const;
   void addEnemyCheck(EnemyCheck*);
   void removeEnemyCheck(EnemyCheck*);
@@ -139,6 +148,7 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
 
   void increaseExpLevel(double);
   int getExpLevel() const;
+  /** Returns the highest strength the creature has had so far.*/
   int getDifficultyPoints() const;
 
   string getDescription() const;
@@ -151,7 +161,7 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
 
   class Action {
     public:
-    Action(function<void()>);
+    Action(SmallFunction);
     Action(const string& failedReason);
 #ifndef RELEASE
     // This stuff is so that you don't forget to perform() an action or check if it failed
@@ -159,16 +169,18 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
     Action(const Action&);
     ~Action();
 #endif
-    Action prepend(function<void()>);
-    Action append(function<void()>);
+    Action prepend(SmallFunction);
+    Action append(SmallFunction);
     void perform();
     string getFailedReason() const;
     operator bool() const;
 
     private:
-    function<void()> action;
-    function<void()> before;
-    function<void()> after;
+    // Prepended and appended steps are kept side by side with the action, so chaining them doesn't
+    // wrap the previous ones in a bigger closure.
+    static const int maxSteps = 4;
+    SmallFunction steps[maxSteps];
+    int numSteps = 0;
     string failedMessage;
 #ifndef RELEASE
     mutable bool wasUsed = false;
@@ -262,8 +274,20 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
     ar & defaultCreature;
     ar & defaultFlyer;
     ar & defaultMinion;
+    ar & effectTimeouts;
   }
 
+  struct EffectTimeout {
+    Creature* creature;
+    LastingEffect effect;
+
+    template <class Archive> 
+    void serialize(Archive& ar, const unsigned int version);
+  };
+
+  /** Times out all lasting effects that expired before \paramname{time}, for all creatures.*/
+  static void timeOutEffects(double time);
+
   void addEffect(LastingEffect, double time, bool msg = true);
   void removeEffect(LastingEffect, bool msg = true);
   bool isAffected(LastingEffect) const;
@@ -279,12 +303,16 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   static PCreature defaultCreature;
   static PCreature defaultFlyer;
   static PCreature defaultMinion;
+  static TimerWheel<EffectTimeout> effectTimeouts;
   Action moveTowards(Vec2 pos, bool away, bool stepOnTile);
   double getInventoryWeight() const;
   Item* getAmmo() const;
   void updateViewObject();
   int getStrengthAttackBonus() const;
   int getAttrVal(AttrType type) const;
+  int computeAttr(AttrType type) const;
+  void updateStatCache() const;
+  void invalidateStats() const;
   int getToHit() const;
   BodyPart getBodyPart(AttackLevel attack) const;
   bool isFireResistant() const;
@@ -295,6 +323,9 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   void spendTime(double time);
   BodyPart armOrWing() const;
   pair<double, double> getStanding(const Creature* c) const;
+  static int takeSlot();
+  void freeSlot();
+  int slot = takeSlot();
 
   ViewObject SERIAL(viewObject);
   Level* SERIAL2(level, nullptr);
@@ -304,7 +335,7 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   Optional<ShortestPath> SERIAL(shortestPath);
   unordered_set<const Creature*> SERIAL(knownHiding);
   Tribe* SERIAL(tribe);
-  vector<EnemyCheck*> SERIAL(enemyChecks);
+  EnemyCheck* SERIAL2(enemyCheck, nullptr);
   double SERIAL2(health, 1);
   bool SERIAL2(dead, false);
   double SERIAL2(lastTick, 0);
@@ -318,16 +349,27 @@ class Creature : public CreatureAttributes, public CreatureView, public UniqueEn
   int SERIAL2(swapPositionCooldown, 0);
   double SERIAL2(expLevel, 1);
   vector<const Creature*> SERIAL(unknownAttacker);
-  vector<const Creature*> SERIAL(privateEnemies);
+  unordered_set<const Creature*> SERIAL(privateEnemies);
   const Creature* SERIAL2(holding, nullptr);
   PController SERIAL(controller);
   vector<PController> SERIAL(controllerStack);
   vector<CreatureVision*> SERIAL(creatureVisions);
   mutable vector<const Creature*> SERIAL(kills);
-  mutable double SERIAL2(difficultyPoints, 0);
-  int SERIAL2(points, 0);
+  double SERIAL2(difficultyPoints, 0);
+  double getCurrentDifficultyPoints() const;
+  // Called where the strength can grow, raises a DIFFICULTY_CHANGED event when it does.
+  void updateDifficultyPoints();
+  mutable int SERIAL2(points, 0);
   Sectors* SERIAL2(sectors, nullptr);
   int SERIAL2(numAttacksThisTurn, 0);
+  // Attributes and inventory weight, kept while the creature's time, its tribe's handicap and its equipment
+  // are unchanged. Everything else they depend on calls invalidateStats() when it changes.
+  mutable vector<int> attrCache;
+  mutable double inventoryWeight = -1;
+  mutable bool statCacheValid = false;
+  mutable double statCacheTime = 0;
+  mutable int statCacheHandicap = 0;
+  mutable int statCacheVersion = 0;
 };
 
 struct SpellInfo {
@@ -462,6 +462,10 @@ class ShopkeeperController : public Monster, public EventListener {
     unpaidItems.erase(from);
   }
   
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return {EventId::ITEMS_APPEARED, EventId::PICKUP, EventId::DROP};
+  }
+
   virtual void onItemsAppearedEvent(Vec2 position, const vector<Item*>& items) override {
     if (position.inRectangle(shopArea->getBounds())) {
       for (Item* it : items) {
@@ -975,7 +979,7 @@ PCreature getSpecial(const string& name, Tribe* tribe, bool humanoid, Controller
     }
 
   }
-  Debug() << c->getDescription();
+  LOG << c->getDescription();
   return c;
 }
 
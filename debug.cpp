@@ -15,6 +15,14 @@
 
 #include "stdafx.h"
 
+#include <mutex>
+#include <condition_variable>
+#include <csignal>
+#ifndef WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "debug.h"
 #include "util.h"
 
@@ -28,27 +36,149 @@ Debug::Debug(DebugType t, const string& msg, int line)
 #endif
 }
 
-static ofstream output;
+namespace {
+
+class LogWriter {
+  public:
+  void open(const string& path) {
+    output.open(path);
+#ifndef WINDOWS
+    crashFd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+#endif
+    writer = thread([this] { run(); });
+  }
+
+  // Only uses write(2), so it's safe to call from a signal handler. Lines still in the queue are lost.
+  void writeCrashMarker() {
+#ifndef WINDOWS
+    static const char msg[] = "FATAL Crashed with a signal, some log lines might be missing\n";
+    if (crashFd >= 0 && ::write(crashFd, msg, sizeof(msg) - 1)) {}
+#endif
+  }
+
+  // Doesn't wake up the writer, which picks up the lines in batches, so logging costs no system call.
+  void push(string line) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    lines.push_back(std::move(line));
+  }
+
+  void writeNow(const string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    write(takeLines());
+    output << line << endl;
+    output.flush();
+  }
+
+  // Called from std::terminate, so it doesn't wait for locks that the crashing thread might hold.
+  void flushOnCrash() {
+    std::unique_lock<std::mutex> outputLock(outputMutex, std::try_to_lock);
+    std::unique_lock<std::mutex> queueLock(queueMutex, std::try_to_lock);
+    if (outputLock && queueLock) {
+      write(lines);
+      lines.clear();
+    }
+    output.flush();
+  }
+
+  ~LogWriter() {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      done = true;
+    }
+    ready.notify_one();
+    if (writer.joinable())
+      writer.join();
+  }
+
+  private:
+  void run() {
+    while (1) {
+      {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        ready.wait_for(lock, std::chrono::milliseconds(batchMillis), [this] { return done; });
+        if (done && lines.empty())
+          return;
+      }
+      std::lock_guard<std::mutex> lock(outputMutex);
+      write(takeLines());
+      output.flush();
+    }
+  }
+
+  vector<string> takeLines() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    vector<string> ret;
+    ret.swap(lines);
+    return ret;
+  }
+
+  void write(const vector<string>& batch) {
+    for (const string& line : batch)
+      output << line << '\n';
+  }
+
+  ofstream output;
+  vector<string> lines;
+  std::mutex queueMutex;
+  std::mutex outputMutex;
+  std::condition_variable ready;
+  bool done = false;
+  static const int batchMillis = 20;
+  thread writer;
+  int crashFd = -1;
+};
+
+LogWriter logWriter;
+
+std::terminate_handler defaultTerminate = nullptr;
+
+void onCrash(int sig) {
+  logWriter.writeCrashMarker();
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+void onTerminate() {
+  logWriter.flushOnCrash();
+  defaultTerminate();
+}
+
+}
+
+bool Debug::logging = false;
 
 void Debug::init() {
-  output.open("log.out");
+  logWriter.open("log.out");
+#ifndef RELEASE
+  logging = true;
+  // queued lines would be lost on a crash
+#ifndef WINDOWS
+  for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGILL})
+    signal(sig, onCrash);
+#endif
+  defaultTerminate = std::set_terminate(onTerminate);
+#endif
+}
+
+void Debug::setLogging(bool state) {
+  logging = state;
 }
 
 void Debug::add(const string& a) {
   out += a;
 }
+
 Debug::~Debug() {
   if (type == FATAL) {
-    output << out << endl;
-    output.flush();
+    logWriter.writeNow(out);
     throw out;
   } else {
 #ifndef RELEASE
-    output << out << endl;
-    output.flush();
+    logWriter.push(std::move(out));
 #endif
   }
 }
+
 Debug& Debug::operator <<(const string& msg) {
   add(msg);
   return *this;
@@ -33,6 +33,14 @@
 #define TRY(exp, msg) exp
 #endif
 
+/** Logs an INFO line, e.g. LOG << "Turn " << time. In RELEASE builds the statement compiles away
+  and its arguments are never evaluated, otherwise they are only evaluated if logging is turned on.*/
+#ifdef RELEASE
+#define LOG if (true) {} else Debug()
+#else
+#define LOG if (!Debug::isLogging()) {} else Debug()
+#endif
+
 #ifndef WINDOWS
 
 #define MEASURE(exp, text) do { \
@@ -67,7 +75,12 @@ class NoDebug {
 class Debug {
   public:
   Debug(DebugType t = INFO, const string& msg = "", int line = 0);
+  /** Opens the log file and starts the thread that writes to it.*/
   static void init();
+  static bool isLogging() {
+    return logging;
+  }
+  static void setLogging(bool);
   Debug& operator <<(const string& msg);
   Debug& operator <<(const int msg);
   Debug& operator <<(const char msg);
@@ -82,6 +95,7 @@ class Debug {
   string out;
   DebugType type;
   void add(const string& a);
+  static bool logging;
 };
 
 template <class T, class V>
@@ -0,0 +1,73 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#include "stdafx.h"
+
+#include "delay_map.h"
+
+template <class Archive> 
+void DelayMap::serialize(Archive& ar, const unsigned int version) {
+  boost::serialization::split_member(ar, *this, version);
+}
+
+template <class Archive> 
+void DelayMap::save(Archive& ar, const unsigned int version) const {
+  vector<pair<Vec2, double>> delays;
+  for (Vec2 v : active)
+    delays.emplace_back(v, until[v]);
+  ar << BOOST_SERIALIZATION_NVP(bounds) << BOOST_SERIALIZATION_NVP(delays);
+}
+
+template <class Archive> 
+void DelayMap::load(Archive& ar, const unsigned int version) {
+  vector<pair<Vec2, double>> delays;
+  ar >> BOOST_SERIALIZATION_NVP(bounds) >> BOOST_SERIALIZATION_NVP(delays);
+  until = Table<double>(bounds, -1);
+  active.clear();
+  for (auto& elem : delays)
+    delay(elem.first, elem.second);
+}
+
+SERIALIZABLE(DelayMap);
+
+DelayMap::DelayMap(Rectangle b) : bounds(b), until(b, -1) {
+}
+
+void DelayMap::delay(Vec2 pos, double time) {
+  if (until[pos] < 0)
+    active.push_back(pos);
+  until[pos] = max(until[pos], time);
+}
+
+bool DelayMap::isDelayed(Vec2 pos, double time) const {
+  return until[pos] > time;
+}
+
+double DelayMap::getDelayEnd(Vec2 pos) const {
+  return until[pos];
+}
+
+void DelayMap::expire(double time) {
+  for (int i = active.size() - 1; i >= 0; --i)
+    if (until[active[i]] <= time) {
+      until[active[i]] = -1;
+      active[i] = active.back();
+      active.pop_back();
+    }
+}
+
+int DelayMap::getSize() const {
+  return active.size();
+}
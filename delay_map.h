@@ -0,0 +1,51 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _DELAY_MAP_H
+#define _DELAY_MAP_H
+
+#include "util.h"
+
+/** Positions within fixed bounds that are delayed until a given time. Checking a position is a single
+    table lookup and delays run out on their own. The positions that are still delayed are also kept
+    in a list, so that expired ones can be forgotten and only live ones are saved.*/
+class DelayMap {
+  public:
+  DelayMap(Rectangle bounds);
+
+  void delay(Vec2, double until);
+  bool isDelayed(Vec2, double time) const;
+
+  /** Returns the time until which the position is delayed, or a negative number if it isn't.*/
+  double getDelayEnd(Vec2) const;
+
+  /** Forgets all delays that ended before \paramname{time}.*/
+  void expire(double time);
+  int getSize() const;
+
+  SERIALIZATION_DECL(DelayMap);
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const;
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version);
+
+  private:
+  Rectangle bounds;
+  Table<double> until;
+  vector<Vec2> active;
+};
+
+#endif
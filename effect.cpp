@@ -266,6 +266,7 @@ static void enhanceArmor(Creature* c, int mod = 1, const string msg = "is improv
       c->you(MsgType::YOUR, item->getName() + " " + msg);
       if (item->getModifier(AttrType::DEFENSE) > 0 || mod > 0)
         item->addModifier(AttrType::DEFENSE, mod);
+      c->onEquipmentModified();
       return;
     }
 }
@@ -274,6 +275,7 @@ static void enhanceWeapon(Creature* c, int mod = 1, const string msg = "is impro
   if (Item* item = c->getEquipment().getItem(EquipmentSlot::WEAPON)) {
     c->you(MsgType::YOUR, item->getName() + " " + msg);
     item->addModifier(chooseRandom({AttrType::TO_HIT, AttrType::DAMAGE}), mod);
+    c->onEquipmentModified();
   }
 }
 
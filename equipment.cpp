@@ -62,11 +62,13 @@ EquipmentSlot Equipment::getSlot(const Item* item) const {
 void Equipment::equip(Item* item, EquipmentSlot slot) {
   items[slot] = item;
   CHECK(hasItem(item));
+  onChanged();
 }
 
 void Equipment::unequip(EquipmentSlot slot) {
   CHECK(items.count(slot) > 0);
   items.erase(slot);
+  onChanged();
 }
 
 PItem Equipment::removeItem(Item* item) {
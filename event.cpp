@@ -18,116 +18,237 @@
 #include "event.h"
 #include "creature.h"
 
-vector<EventListener*> EventListener::listeners;
+EnumMap<EventId, vector<EventListener*>> EventListener::listeners;
+vector<EventListener*> EventListener::pending;
+int EventListener::dispatchDepth = 0;
+bool EventListener::needsCompaction = false;
 
 EventListener::EventListener() {
-  listeners.push_back(this);
+  for (EventId id : ENUM_ALL(EventId))
+    subscriptionIndex[id] = -1;
+  pendingIndex = pending.size();
+  pending.push_back(this);
+}
+
+EventListener::EventListener(const EventListener&) : EventListener() {
+}
+
+EventListener& EventListener::operator = (const EventListener&) {
+  return *this;
 }
 
 EventListener::~EventListener() {
-  removeElement(listeners, this);
+  if (pendingIndex > -1) {
+    pending[pendingIndex] = pending.back();
+    pending[pendingIndex]->pendingIndex = pendingIndex;
+    pending.pop_back();
+  }
+  for (EventId id : ENUM_ALL(EventId))
+    if (subscriptionIndex[id] > -1) {
+      // Don't move other listeners around while an event is being dispatched, just leave a hole.
+      if (dispatchDepth > 0) {
+        listeners[id][subscriptionIndex[id]] = nullptr;
+        needsCompaction = true;
+      } else
+        removeListener(id, subscriptionIndex[id]);
+    }
+}
+
+void EventListener::removeListener(EventId id, int index) {
+  vector<EventListener*>& v = listeners[id];
+  v[index] = v.back();
+  if (v[index])
+    v[index]->subscriptionIndex[id] = index;
+  v.pop_back();
+}
+
+void EventListener::compact() {
+  for (EventId id : ENUM_ALL(EventId))
+    for (int i = int(listeners[id].size()) - 1; i >= 0; --i)
+      if (!listeners[id][i])
+        removeListener(id, i);
+  needsCompaction = false;
+}
+
+void EventListener::subscribePending() {
+  while (!pending.empty()) {
+    EventListener* l = pending.back();
+    pending.pop_back();
+    l->pendingIndex = -1;
+    for (EventId id : l->getSubscribedEvents())
+      if (l->subscriptionIndex[id] == -1) {
+        l->subscriptionIndex[id] = listeners[id].size();
+        listeners[id].push_back(l);
+      }
+  }
+}
+
+namespace {
+
+struct DispatchGuard {
+  DispatchGuard(int& d) : depth(d) { ++depth; }
+  ~DispatchGuard() { --depth; }
+  int& depth;
+};
+
+}
+
+void EventListener::forEachListener(EventId id, function<void(EventListener*)> f) {
+  subscribePending();
+  {
+    DispatchGuard guard(dispatchDepth);
+    // Listeners subscribed during the dispatch are appended and won't receive this event.
+    int numListeners = listeners[id].size();
+    for (int i = 0; i < numListeners; ++i)
+      if (EventListener* l = listeners[id][i])
+        f(l);
+  }
+  if (dispatchDepth == 0 && needsCompaction)
+    compact();
+}
+
+bool EventListener::listensTo(const Level* level) const {
+  const Level* l = getListenerLevel();
+  return l == level || l == nullptr;
 }
 
 void EventListener::initialize() {
 #ifndef RELEASE // for some reason this sometimes fails on windows
-  CHECK(listeners.empty());
+  for (EventId id : ENUM_ALL(EventId))
+    CHECK(listeners[id].empty());
+  CHECK(pending.empty());
 #endif
 }
 
 void EventListener::addPickupEvent(const Creature* c, const vector<Item*>& items) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::PICKUP, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onPickupEvent(c, items);
+  });
 }
 
 void EventListener::addDropEvent(const Creature* c, const vector<Item*>& items) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::DROP, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onDropEvent(c, items);
+  });
 }
 
 void EventListener::addItemsAppearedEvent(const Level* level, Vec2 position, const vector<Item*>& items) {
-  for (EventListener* l : listeners)
+  forEachListener(EventId::ITEMS_APPEARED, [&](EventListener* l) {
     if (l->getListenerLevel() == level)
       l->onItemsAppearedEvent(position, items);
+  });
 }
 
 void EventListener::addKillEvent(const Creature* victim, const Creature* killer) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == victim->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::KILL, [&](EventListener* l) {
+    if (l->listensTo(victim->getLevel()))
       l->onKillEvent(victim, killer);
+  });
 }
   
 void EventListener::addAttackEvent(const Creature* victim, const Creature* attacker) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == victim->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::ATTACK, [&](EventListener* l) {
+    if (l->listensTo(victim->getLevel()))
       l->onAttackEvent(victim, attacker);
+  });
 }
 
 void EventListener::addThrowEvent(const Level* level, const Creature* thrower,
     const Item* item, const vector<Vec2>& trajectory) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::THROW, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onThrowEvent(thrower, item, trajectory);
+  });
 }
   
 void EventListener::addExplosionEvent(const Level* level, Vec2 pos) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::EXPLOSION, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onExplosionEvent(level, pos);
+  });
 }
 
 void EventListener::addTriggerEvent(const Level* level, Vec2 pos) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::TRIGGER, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onTriggerEvent(level, pos);
+  });
 }
 
 void EventListener::addSquareReplacedEvent(const Level* level, Vec2 pos) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::SQUARE_REPLACED, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onSquareReplacedEvent(level, pos);
+  });
 }
   
 void EventListener::addChangeLevelEvent(const Creature* c, const Level* level, Vec2 pos,
     const Level* to, Vec2 toPos) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::CHANGE_LEVEL, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onChangeLevelEvent(c, level, pos, to, toPos);
+  });
 }
   
 void EventListener::addCombatEvent(const Creature* c) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::COMBAT, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onCombatEvent(c);
+  });
 }
 
 void EventListener::addAlarmEvent(const Level* level, Vec2 pos) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == level || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::ALARM, [&](EventListener* l) {
+    if (l->listensTo(level))
       l->onAlarmEvent(level, pos);
+  });
 }
   
 void EventListener::addTechBookEvent(Technology* t) {
-  for (EventListener* l : listeners)
+  forEachListener(EventId::TECH_BOOK, [&](EventListener* l) {
     l->onTechBookEvent(t);
+  });
 }
   
 void EventListener::addEquipEvent(const Creature* c, const Item* it) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::EQUIP, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onEquipEvent(c, it);
+  });
 }
 
 void EventListener::addSurrenderEvent(Creature* c, const Creature* to) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::SURRENDER, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onSurrenderEvent(c, to);
+  });
 }
   
 void EventListener::addTortureEvent(Creature* c, const Creature* torturer) {
-  for (EventListener* l : listeners)
-    if (l->getListenerLevel() == c->getLevel() || l->getListenerLevel() == nullptr)
+  forEachListener(EventId::TORTURE, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
       l->onTortureEvent(c, torturer);
+  });
 }
 
+void EventListener::addMoveEvent(const Creature* c) {
+  forEachListener(EventId::MOVE, [&](EventListener* l) {
+    if (l->listensTo(c->getLevel()))
+      l->onMoveEvent(c);
+  });
+}
+
+void EventListener::addItemsChangedEvent(const Level* level, Vec2 pos) {
+  forEachListener(EventId::ITEMS_CHANGED, [&](EventListener* l) {
+    if (l->listensTo(level))
+      l->onItemsChangedEvent(level, pos);
+  });
+}
+
+void EventListener::addDifficultyChangedEvent(const Creature* c) {
+  forEachListener(EventId::DIFFICULTY_CHANGED, [&](EventListener* l) {
+    l->onDifficultyChangedEvent(c);
+  });
+}
@@ -24,6 +24,32 @@ class Item;
 class Quest;
 class Technology;
 
+enum class EventId {
+  PICKUP,
+  DROP,
+  ITEMS_APPEARED,
+  KILL,
+  ATTACK,
+  COMBAT,
+  THROW,
+  EXPLOSION,
+  TRIGGER,
+  SQUARE_REPLACED,
+  CHANGE_LEVEL,
+  ALARM,
+  TECH_BOOK,
+  EQUIP,
+  SURRENDER,
+  TORTURE,
+  MOVE,
+  ITEMS_CHANGED,
+  DIFFICULTY_CHANGED,
+
+  ENUM_END
+};
+
+/** Listeners are notified only of the kinds of events returned by getSubscribedEvents().
+    The subscriptions are read lazily, before the next event is dispatched after construction.*/
 class EventListener {
   public:
   virtual void onPickupEvent(const Creature*, const vector<Item*>& items) {}
@@ -43,6 +69,12 @@ class EventListener {
   virtual void onEquipEvent(const Creature*, const Item*) {}
   virtual void onSurrenderEvent(Creature* who, const Creature* to) {}
   virtual void onTortureEvent(Creature* who, const Creature* torturer) {}
+  // triggered whenever a creature is put on a square, eg. moved, swapped or placed on a level
+  virtual void onMoveEvent(const Creature*) {}
+  // triggered whenever items are added to or removed from a square
+  virtual void onItemsChangedEvent(const Level*, Vec2 pos) {}
+  // triggered when a creature becomes more dangerous, on any level
+  virtual void onDifficultyChangedEvent(const Creature*) {}
 
   static void addPickupEvent(const Creature*, const vector<Item*>& items);
   static void addDropEvent(const Creature*, const vector<Item*>& items);
@@ -60,7 +92,11 @@ class EventListener {
   static void addEquipEvent(const Creature*, const Item*);
   static void addSurrenderEvent(Creature* who, const Creature* to);
   static void addTortureEvent(Creature* who, const Creature* torturer);
+  static void addMoveEvent(const Creature*);
+  static void addItemsChangedEvent(const Level*, Vec2 pos);
+  static void addDifficultyChangedEvent(const Creature*);
 
+  virtual vector<EventId> getSubscribedEvents() const { return {}; }
   virtual const Level* getListenerLevel() const { return nullptr; }
   static void initialize();
 
@@ -69,10 +105,22 @@ class EventListener {
   }
 
   EventListener();
+  EventListener(const EventListener&);
+  EventListener& operator = (const EventListener&);
   virtual ~EventListener();
 
   private:
-  static vector<EventListener*> listeners;
+  bool listensTo(const Level*) const;
+  static void subscribePending();
+  static void forEachListener(EventId, function<void(EventListener*)>);
+  static void removeListener(EventId, int index);
+  static void compact();
+  static EnumMap<EventId, vector<EventListener*>> listeners;
+  static vector<EventListener*> pending;
+  static int dispatchDepth;
+  static bool needsCompaction;
+  EnumMap<EventId, int> subscriptionIndex;
+  int pendingIndex;
 };
 
 #endif
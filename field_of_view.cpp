@@ -16,6 +16,7 @@
 #include "stdafx.h"
 
 #include "field_of_view.h"
+#include "profiler.h"
 
 template <class Archive> 
 void FieldOfView::serialize(Archive& ar, const unsigned int version) {
@@ -72,6 +73,7 @@ static int totalIter = 0;
 static int numSamples = 0;
 
 FieldOfView::Visibility::Visibility(const Table<PSquare>& squares, Vision* vision, int x, int y) : px(x), py(y) {
+  PROFILE("field of view");
   memset(visible, 0, (2 * sightRange + 1) * (2 * sightRange + 1));
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
       [&](int px, int py) { return !squares[x + px][y + py]->canSeeThru(vision); },
@@ -89,7 +91,7 @@ FieldOfView::Visibility::Visibility(const Table<PSquare>& squares, Vision* visio
 /*  ++numSamples;
   totalIter += visibleTiles.size();
   if (numSamples%100 == 0)
-    Debug() << numSamples << " iterations " << totalIter / numSamples << " avg";*/
+    LOG << numSamples << " iterations " << totalIter / numSamples << " avg";*/
 }
 
 const vector<Vec2>& FieldOfView::Visibility::getVisibleTiles() const {
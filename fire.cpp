@@ -43,6 +43,11 @@ void Fire::tick(Level* level, Vec2 position) {
   }
 }
 
+void Fire::catchUp(double turns) {
+  for (int i = 0; i < turns && isBurning(); ++i)
+    tick(nullptr, Vec2(0, 0));
+}
+
 void Fire::set(double amount) {
   if (!isBurntOut() && amount > epsilon)
     size = max(size, amount * flamability);
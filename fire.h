@@ -23,6 +23,8 @@ class Fire {
   public:
   Fire(double objectWeight, double objectFlamability);
   void tick(Level* level, Vec2 position);
+  /** Advances the fire by the given number of turns at once.*/
+  void catchUp(double turns);
   void set(double amount);
   bool isBurning() const;
   double getSize() const;
@@ -19,15 +19,55 @@
 
 template <class Archive> 
 void Inventory::serialize(Archive& ar, const unsigned int version) {
-  ar& SVAR(items)
-    & SVAR(itemsCache);
-  CHECK_SERIAL;
+  boost::serialization::split_member(ar, *this, version);
+}
+
+// items are saved in the order they were added
+template <class Archive> 
+void Inventory::save(Archive& ar, const unsigned int version) const {
+  int count = items.size();
+  ar << BOOST_SERIALIZATION_NVP(count);
+  for (const PItem* item : getItemsInOrder())
+    ar << boost::serialization::make_nvp("item", *item);
+}
+
+template <class Archive> 
+void Inventory::load(Archive& ar, const unsigned int version) {
+  int count;
+  ar >> BOOST_SERIALIZATION_NVP(count);
+  items.clear();
+  itemsByType.clear();
+  numAdded = 0;
+  while (count-- > 0) {
+    PItem item;
+    ar >> boost::serialization::make_nvp("item", item);
+    addToSlots(item.get(), items.size());
+    items.push_back(std::move(item));
+  }
 }
 
 SERIALIZABLE(Inventory);
 
+void Inventory::addToSlots(Item* item, int slot) {
+  vector<Item*>& bucket = itemsByType[item->getType()];
+  item->inventorySlot = slot;
+  item->inventoryTypeSlot = bucket.size();
+  item->inventoryOrder = numAdded++;
+  bucket.push_back(item);
+}
+
+vector<const PItem*> Inventory::getItemsInOrder() const {
+  vector<const PItem*> ret;
+  for (const PItem& item : items)
+    ret.push_back(&item);
+  sort(ret.begin(), ret.end(), [](const PItem* a, const PItem* b) {
+      return (*a)->inventoryOrder < (*b)->inventoryOrder; });
+  return ret;
+}
+
 void Inventory::addItem(PItem item) {
-  itemsCache.push_back(item.get());
+  onChanged();
+  addToSlots(item.get(), items.size());
   items.push_back(move(item));
 }
 
@@ -37,16 +77,20 @@ void Inventory::addItems(vector<PItem> v) {
 }
 
 PItem Inventory::removeItem(Item* itemRef) {
-  int ind = -1;
-  for (int i : All(items))
-    if (items[i].get() == itemRef) {
-      ind = i;
-      break;
-    }
-  CHECK(ind > -1) << "Tried to remove unknown item.";
-  PItem item = std::move(items[ind]);
-  items.erase(items.begin() + ind);
-  removeElement(itemsCache, itemRef);
+  CHECK(hasItem(itemRef)) << "Tried to remove unknown item.";
+  onChanged();
+  vector<Item*>& bucket = itemsByType.at(itemRef->getType());
+  bucket[itemRef->inventoryTypeSlot] = bucket.back();
+  bucket[itemRef->inventoryTypeSlot]->inventoryTypeSlot = itemRef->inventoryTypeSlot;
+  bucket.pop_back();
+  int slot = itemRef->inventorySlot;
+  PItem item = std::move(items[slot]);
+  if (slot < int(items.size()) - 1) {
+    items[slot] = std::move(items.back());
+    items[slot]->inventorySlot = slot;
+  }
+  items.pop_back();
+  item->inventorySlot = item->inventoryTypeSlot = item->inventoryOrder = -1;
   return item;
 }
 
@@ -58,7 +102,12 @@ vector<PItem> Inventory::removeItems(vector<Item*> items) {
 }
 
 vector<PItem> Inventory::removeAllItems() {
-  itemsCache.clear();
+  onChanged();
+  itemsByType.clear();
+  sort(items.begin(), items.end(), [](const PItem& a, const PItem& b) {
+      return a->inventoryOrder < b->inventoryOrder; });
+  for (PItem& item : items)
+    item->inventorySlot = item->inventoryTypeSlot = item->inventoryOrder = -1;
   return move(items);
 }
 
@@ -71,14 +120,28 @@ vector<Item*> Inventory::getItems(function<bool (Item*)> predicate) const {
 }
 
 vector<Item*> Inventory::getItems() const {
-  return itemsCache;
+  vector<Item*> ret;
+  ret.reserve(items.size());
+  for (const PItem& item : items)
+    ret.push_back(item.get());
+  return ret;
+}
+
+const vector<Item*>& Inventory::getItems(ItemType type) const {
+  static const vector<Item*> empty;
+  auto it = itemsByType.find(type);
+  if (it == itemsByType.end())
+    return empty;
+  return it->second;
 }
 
 bool Inventory::hasItem(const Item* itemRef) const {
-  for (const PItem& item : items) 
-    if (item.get() == itemRef)
-      return true;
-  return false;
+  int slot = itemRef->inventorySlot;
+  return slot >= 0 && slot < items.size() && items[slot].get() == itemRef;
+}
+
+bool Inventory::isAddedBefore(const Item* a, const Item* b) const {
+  return a->inventoryOrder < b->inventoryOrder;
 }
 
 int Inventory::size() const {
@@ -89,3 +152,11 @@ bool Inventory::isEmpty() const {
   return items.empty();
 }
 
+int Inventory::getVersion() const {
+  return version;
+}
+
+void Inventory::onChanged() {
+  ++version;
+}
+
@@ -21,6 +21,10 @@
 #include "util.h"
 #include "item.h"
 
+/** Items are kept in slots that are stored on the items themselves, so looking an item up and removing
+    it take constant time. Removal moves the last item into the freed slot, so getItems() doesn't return
+    the items in the order they were added, but isAddedBefore() still tells it. Items are also kept in
+    buckets by their type.*/
 class Inventory {
   public:
   void addItem(PItem);
@@ -31,17 +35,38 @@ class Inventory {
 
   vector<Item*> getItems() const;
   vector<Item*> getItems(function<bool (Item*)> predicate) const;
+  /** Returns the items of the given type without copying. The reference is invalidated when the inventory
+    changes.*/
+  const vector<Item*>& getItems(ItemType) const;
 
   bool hasItem(const Item*) const;
   int size() const;
 
+  /** Tells if \paramname{a} was added to the inventory before \paramname{b}.*/
+  bool isAddedBefore(const Item* a, const Item* b) const;
+
   bool isEmpty() const;
 
+  /** Returns a number that changes whenever the contents change, for keying caches.*/
+  int getVersion() const;
+
   SERIALIZATION_DECL(Inventory);
 
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const;
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version);
+
+  protected:
+  void onChanged();
+
   private:
-  vector<PItem> SERIAL(items);
-  vector<Item*> SERIAL(itemsCache);
+  void addToSlots(Item*, int slot);
+  vector<const PItem*> getItemsInOrder() const;
+  vector<PItem> items;
+  map<ItemType, vector<Item*>> itemsByType;
+  int version = 0;
+  int numAdded = 0;
 };
 
 #endif
@@ -53,6 +53,7 @@ Item::~Item() {
 
 void Item::identifyEverything() {
   everythingIdentified = true;
+  ++identifyCount;
 }
 
 bool Item::isEverythingIdentified() {
@@ -60,6 +61,7 @@ bool Item::isEverythingIdentified() {
 }
 
 bool Item::everythingIdentified = false;
+int Item::identifyCount = 0;
  
 static set<string> ident;
 bool Item::isIdentified(const string& name) {
@@ -82,29 +84,79 @@ ItemPredicate Item::namePredicate(const string& name) {
   return [name](const Item* item) { return item->getName() == name; };
 }
 
+static unsigned long long combineKey(unsigned long long key, unsigned long long value) {
+  return key * 1000000007ull + value;
+}
+
+unsigned long long Item::getStackKey() const {
+  if (!stackKeyValid || stackKeyIdentifyCount != identifyCount) {
+    stackKey = hash<string>()(isIdentified(*name) ? getRealName(false) : getVisibleName(false));
+    if (uses > -1 && displayUses && inspected)
+      stackKey = combineKey(combineKey(stackKey, 1), uses);
+    if (inspected) {
+      if (artifactName)
+        stackKey = combineKey(combineKey(stackKey, 2), hash<string>()(*artifactName));
+      if (getType() == ItemType::WEAPON)
+        stackKey = combineKey(combineKey(combineKey(stackKey, 3), toHit), damage);
+      if (getType() == ItemType::RANGED_WEAPON)
+        stackKey = combineKey(combineKey(stackKey, 4), rangedWeaponAccuracy);
+      if (getType() == ItemType::ARMOR)
+        stackKey = combineKey(combineKey(stackKey, 5), defense);
+    }
+    stackKeyValid = true;
+    stackKeyIdentifyCount = identifyCount;
+  }
+  unsigned long long ret = stackKey;
+  if (fire.isBurning())
+    ret = combineKey(ret, 6);
+  if (getShopkeeper())
+    ret = combineKey(combineKey(ret, 7), getPrice());
+  return ret;
+}
+
+void Item::invalidateStackKey() {
+  stackKeyValid = false;
+}
+
 vector<pair<string, vector<Item*>>> Item::stackItems(vector<Item*> items, function<string(const Item*)> suffix) {
-  map<string, vector<Item*>> stacks = groupBy<Item*, string>(items, [suffix](const Item* item) {
-        return item->getNameAndModifiers() + suffix(item);
-      });
+  unordered_map<unsigned long long, vector<Item*>> stacks;
+  for (Item* item : items) {
+    unsigned long long key = item->getStackKey();
+    if (suffix)
+      key = combineKey(key, hash<string>()(suffix(item)));
+    stacks[key].push_back(item);
+  }
+  vector<pair<string, vector<Item*>>> named;
+  for (auto& elem : stacks)
+    named.emplace_back(elem.second[0]->getNameAndModifiers() + (suffix ? suffix(elem.second[0]) : ""),
+        std::move(elem.second));
+  sort(named.begin(), named.end(),
+      [](const pair<string, vector<Item*>>& a, const pair<string, vector<Item*>>& b) {
+        return a.first < b.first; });
+  // Stacks whose keys differ but which are named the same are still shown as one.
   vector<pair<string, vector<Item*>>> ret;
-  for (auto elem : stacks)
-    if (elem.second.size() > 1)
-      ret.emplace_back(
-          convertToString<int>(elem.second.size()) + " " 
-          + elem.second[0]->getNameAndModifiers(true) + suffix(elem.second[0]), elem.second);
+  for (auto& elem : named)
+    if (!ret.empty() && ret.back().first == elem.first)
+      append(ret.back().second, elem.second);
     else
-      ret.push_back(elem);
+      ret.push_back(std::move(elem));
+  for (auto& elem : ret)
+    if (elem.second.size() > 1)
+      elem.first = convertToString<int>(elem.second.size()) + " "
+          + elem.second[0]->getNameAndModifiers(true) + (suffix ? suffix(elem.second[0]) : "");
   return ret;
 }
 
 void Item::identify(const string& name) {
-  Debug() << "Identify " << name;
-  ident.insert(name);
+  LOG << "Identify " << name;
+  if (ident.insert(name).second)
+    ++identifyCount;
 }
 
 void Item::identify() {
   identify(*name);
   inspected = true;
+  invalidateStackKey();
 }
 
 bool Item::canIdentify() const {
@@ -141,7 +193,7 @@ double Item::getFireSize() const {
 
 void Item::tick(double time, Level* level, Vec2 position) {
   if (fire.isBurning()) {
-    Debug() << getName() << " burning " << fire.getSize();
+    LOG << getName() << " burning " << fire.getSize();
     level->getSquare(position)->setOnFire(fire.getSize());
     viewObject.setBurning(fire.getSize());
     fire.tick(level, position);
@@ -153,6 +205,10 @@ void Item::tick(double time, Level* level, Vec2 position) {
   specialTick(time, level, position);
 }
 
+bool Item::needsTicking() const {
+  return fire.isBurning() || needsTickingSpecial();
+}
+
 void Item::onHitSquareMessage(Vec2 position, Square* s, bool plural) {
   if (fragile) {
     s->getConstLevel()->globalMessage(position,
@@ -225,10 +281,13 @@ void Item::apply(Creature* c, Level* l) {
     identify(*name);
   if (effect)
     Effect::applyToCreature(c, *effect, EffectStrength::NORMAL);
-  if (uses > -1 && --uses == 0) {
-    discarded = true;
-    if (usedUpMsg)
-      c->playerMessage(getTheName() + " is used up.");
+  if (uses > -1) {
+    invalidateStackKey();
+    if (--uses == 0) {
+      discarded = true;
+      if (usedUpMsg)
+        c->playerMessage(getTheName() + " is used up.");
+    }
   }
 }
 
@@ -270,6 +329,7 @@ string Item::getNoSeeApplyMsg() const {
 
 void Item::setName(const string& n) {
   name = n;
+  invalidateStackKey();
 }
 
 string Item::getName(bool plural, bool blind) const {
@@ -406,6 +466,7 @@ void Item::addModifier(AttrType attributeType, int value) {
     case AttrType::INV_LIMIT: break;
     default: FAIL << "Attribute not handled";
   }
+  invalidateStackKey();
 }
 
 int Item::getModifier(AttrType attributeType) const {
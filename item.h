@@ -66,6 +66,8 @@ class Item : private ItemAttributes, public UniqueEntity {
   int getModifier(AttrType attributeType) const;
 
   void tick(double time, Level*, Vec2 position);
+  /** Checks if the item changes over time when lying on the ground, eg. it's burning or rotting.*/
+  bool needsTicking() const;
   
   string getApplyMsgThirdPerson() const;
   string getApplyMsgFirstPerson() const;
@@ -99,8 +101,10 @@ class Item : private ItemAttributes, public UniqueEntity {
   static ItemPredicate typePredicate(vector<ItemType>);
   static ItemPredicate namePredicate(const string& name);
 
+  /** Groups items that would be displayed the same way. Items are compared by their stack keys, and names
+    are only built for the resulting stacks.*/
   static vector<pair<string, vector<Item*>>> stackItems(vector<Item*>,
-      function<string(const Item*)> addSuffix = [](const Item*) { return ""; });
+      function<string(const Item*)> addSuffix = nullptr);
 
   struct CorpseInfo {
     bool canBeRevived;
@@ -117,6 +121,7 @@ class Item : private ItemAttributes, public UniqueEntity {
 
   protected:
   virtual void specialTick(double time, Level*, Vec2 position) {}
+  virtual bool needsTickingSpecial() const { return false; }
   void setName(const string& name);
   ViewObject SERIAL(viewObject);
   bool SERIAL2(discarded, false);
@@ -128,8 +133,19 @@ class Item : private ItemAttributes, public UniqueEntity {
   string getVisibleName(bool plural) const;
   string getRealName(bool plural) const;
   string getBlindName(bool plural) const;
+  /** Returns a number that is equal for items that getNameAndModifiers() describes the same way.*/
+  unsigned long long getStackKey() const;
+  void invalidateStackKey();
   const Creature* SERIAL2(shopkeeper, nullptr);
   Fire SERIAL(fire);
+  mutable unsigned long long stackKey = 0;
+  mutable bool stackKeyValid = false;
+  mutable int stackKeyIdentifyCount = 0;
+  static int identifyCount;
+  friend class Inventory;
+  int inventorySlot = -1;
+  int inventoryTypeSlot = -1;
+  int inventoryOrder = -1;
 };
 
 #endif
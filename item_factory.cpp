@@ -52,6 +52,10 @@ class FireScroll : public Item {
     }
   }
 
+  virtual bool needsTickingSpecial() const override {
+    return set;
+  }
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version) {
     ar& SUBCLASS(Item)
@@ -236,6 +240,7 @@ class Corpse : public Item {
     if (rottenTime == -1)
       rottenTime = time + rottingTime;
     if (time >= rottenTime && !rotten) {
+      rotten = true;
       setName(rottenName);
       viewObject = object2;
       corpseInfo.isSkeleton = true;
@@ -260,6 +265,10 @@ class Corpse : public Item {
     }
   }
 
+  virtual bool needsTickingSpecial() const override {
+    return !rotten;
+  }
+
   virtual Optional<CorpseInfo> getCorpseInfo() const override { 
     return corpseInfo;
   }
@@ -313,7 +322,7 @@ class Potion : public Item {
 
   virtual void setOnFire(double amount, const Level* level, Vec2 position) override {
     heat += amount;
-    Debug() << getName() << " heat " << heat;
+    LOG << getName() << " heat " << heat;
     if (heat > 0.1) {
       level->globalMessage(position, getAName() + " boils and explodes!");
       discarded = true;
@@ -324,6 +333,10 @@ class Potion : public Item {
     heat = max(0., heat - 0.005);
   }
 
+  virtual bool needsTickingSpecial() const override {
+    return heat > 0;
+  }
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version) {
     ar& SUBCLASS(Item) 
@@ -788,11 +801,11 @@ void makeArtifact(ItemAttributes& i) {
     for (auto elem : badArtifactNames)
       for (auto pattern : elem.second)
         if (contains(toLower(*i.artifactName), pattern) && contains(*i.name, elem.first)) {
-          Debug() << "Rejected artifact " << *i.name << " " << *i.artifactName;
+          LOG << "Rejected artifact " << *i.name << " " << *i.artifactName;
           good = false;
         }
   } while (!good);
-  Debug() << "Making artifact " << *i.name << " " << *i.artifactName;
+  LOG << "Making artifact " << *i.name << " " << *i.artifactName;
   i.damage += Random.getRandom(1, 4);
   i.toHit += Random.getRandom(1, 4);
   i.name = "antique " + *i.name;
@@ -34,7 +34,9 @@ void Level::serialize(Archive& ar, const unsigned int version) {
     & SVAR(backgroundLevel)
     & SVAR(backgroundOffset)
     & SVAR(coverInfo)
-    & SVAR(lightAmount);
+    & SVAR(lightAmount)
+    & SVAR(active)
+    & SVAR(dormantTime);
   CHECK_SERIAL;
 }  
 
@@ -84,11 +86,39 @@ void Level::putCreature(Vec2 position, Creature* c) {
   //getSquare(position)->putCreatureSilently(c);
   getSquare(position)->putCreature(c);
   notifyLocations(c);
+  EventListener::addMoveEvent(c);
 }
   
-void Level::notifyLocations(Creature* c) {
+void Level::updateLocationGrid() const {
+  if (locationGridValid)
+    return;
+  locationGrid = Table<int>(squares.getBounds(), -1);
+  locationSets.clear();
+  // Squares covered by the same locations share one entry in locationSets.
+  map<pair<int, Location*>, int> extended;
   for (Location* l : locations)
-    if (c->getPosition().inRectangle(l->getBounds()))
+    for (Vec2 v : l->getBounds())
+      if (inBounds(v)) {
+        int& index = locationGrid[v];
+        pair<int, Location*> key(index, l);
+        if (!extended.count(key)) {
+          vector<Location*> covering;
+          if (index >= 0)
+            covering = locationSets[index];
+          covering.push_back(l);
+          extended[key] = locationSets.size();
+          locationSets.push_back(covering);
+        }
+        index = extended.at(key);
+      }
+  locationGridValid = true;
+}
+
+void Level::notifyLocations(Creature* c) {
+  updateLocationGrid();
+  int index = locationGrid[c->getPosition()];
+  if (index >= 0)
+    for (Location* l : locationSets[index])
       l->onCreature(c);
 }
 
@@ -103,8 +133,7 @@ void Level::addLightSource(Vec2 pos, double radius, int numLight) {
 }
 
 void Level::replaceSquare(Vec2 pos, PSquare square) {
-  if (contains(tickingSquares, getSquare(pos)))
-    removeElement(tickingSquares, getSquare(pos));
+  removeTickingSquare(pos);
   Creature* c = squares[pos]->getCreature();
   for (Item* it : squares[pos]->getItems())
     square->dropItem(squares[pos]->removeItem(it));
@@ -135,9 +164,12 @@ const Creature* Level::getPlayer() const {
 }
 
 const Location* Level::getLocation(Vec2 pos) const {
-  for (Location* l : locations)
-    if (pos.inRectangle(l->getBounds()))
-      return l;
+  if (!inBounds(pos))
+    return nullptr;
+  updateLocationGrid();
+  int index = locationGrid[pos];
+  if (index >= 0)
+    return locationSets[index][0];
   return nullptr;
 }
 
@@ -344,6 +376,7 @@ void Level::moveCreature(Creature* creature, Vec2 direction) {
   creature->setPosition(position + direction);
   nextSquare->putCreature(creature);
   notifyLocations(creature);
+  EventListener::addMoveEvent(creature);
 }
 
 void Level::swapCreatures(Creature* c1, Creature* c2) {
@@ -359,6 +392,8 @@ void Level::swapCreatures(Creature* c1, Creature* c2) {
   square2->putCreature(c1);
   notifyLocations(c1);
   notifyLocations(c2);
+  EventListener::addMoveEvent(c1);
+  EventListener::addMoveEvent(c2);
 }
 
 vector<Vec2> Level::getVisibleTilesNoDarkness(Vec2 pos, Vision* vision) const {
@@ -400,12 +435,67 @@ Square* Level::getSquare(Vec2 pos) {
 
 void Level::addTickingSquare(Vec2 pos) {
   Square* s = squares[pos].get();
-  if (!contains(tickingSquares, s))
+  if (s->tickingIndex == -1) {
+    s->tickingIndex = tickingSquares.size();
     tickingSquares.push_back(s);
+  }
 }
-  
-vector<Square*> Level::getTickingSquares() const {
-  return tickingSquares;
+
+void Level::removeTickingSquare(Vec2 pos) {
+  Square* s = squares[pos].get();
+  int index = s->tickingIndex;
+  if (index == -1)
+    return;
+  s->tickingIndex = -1;
+  // During a ticking pass only blank the entry, so that the indices of squares yet to be ticked don't change.
+  if (tickingPass)
+    tickingSquares[index] = nullptr;
+  else
+    eraseTickingSquare(index);
+}
+
+void Level::eraseTickingSquare(int index) {
+  if (index < int(tickingSquares.size()) - 1) {
+    tickingSquares[index] = tickingSquares.back();
+    if (tickingSquares[index])
+      tickingSquares[index]->tickingIndex = index;
+  }
+  tickingSquares.pop_back();
+}
+
+void Level::forEachTickingSquare(function<void(Square*)> f) {
+  CHECK(!tickingPass);
+  tickingPass = true;
+  // Squares that start ticking during the pass are appended and will be ticked from the next turn.
+  int numTicking = tickingSquares.size();
+  for (int i = 0; i < numTicking; ++i)
+    if (Square* s = tickingSquares[i])
+      f(s);
+  tickingPass = false;
+  for (int i = int(tickingSquares.size()) - 1; i >= 0; --i)
+    if (!tickingSquares[i])
+      eraseTickingSquare(i);
+}
+
+void Level::tickSquares(double time) {
+  forEachTickingSquare([time](Square* s) { s->tick(time); });
+}
+
+bool Level::isActive() const {
+  return active;
+}
+
+void Level::setDormant(double time) {
+  CHECK(active);
+  active = false;
+  dormantTime = time;
+}
+
+void Level::wakeUp(double time) {
+  CHECK(!active);
+  active = true;
+  double elapsed = time - dormantTime;
+  forEachTickingSquare([time, elapsed](Square* s) { s->catchUp(time, elapsed); });
 }
 
 Level::Builder::Builder(int width, int height, const string& n, bool covered)
@@ -101,8 +101,20 @@ class Level {
   /** The given square's method Square::tick() will be called every turn. */
   void addTickingSquare(Vec2 pos);
 
-  /** Returns all squares that must be ticked. */
-  vector<Square*> getTickingSquares() const;
+  /** Stops ticking the given square. Squares remove themselves once they have nothing time-dependent left.*/
+  void removeTickingSquare(Vec2 pos);
+
+  /** Calls Square::tick() on all ticking squares.*/
+  void tickSquares(double time);
+
+  /** Checks if creatures and squares on this level are currently being simulated.*/
+  bool isActive() const;
+
+  /** Freezes the level. Its creatures and squares won't be updated until wakeUp() is called.*/
+  void setDormant(double time);
+
+  /** Unfreezes the level, applying the time elapsed since setDormant() to all ticking squares in aggregate.*/
+  void wakeUp(double time);
 
   /** Moves the creature to a different level according to \paramname{direction}. */
   void changeLevel(StairDirection direction, StairKey key, Creature* c);
@@ -257,10 +269,17 @@ class Level {
 
   private:
   Vec2 transform(Vec2);
+  void forEachTickingSquare(function<void(Square*)>);
+  void eraseTickingSquare(int index);
   Table<PSquare> SERIAL(squares);
   map<pair<StairDirection, StairKey>, vector<Vec2>> SERIAL(landingSquares);
   vector<Location*> SERIAL(locations);
+  // For every square, an index into locationSets of the locations that cover it, or -1 if there are none.
+  mutable Table<int> locationGrid;
+  mutable vector<vector<Location*>> locationSets;
+  mutable bool locationGridValid = false;
   vector<Square*> SERIAL(tickingSquares);
+  bool tickingPass = false;
   vector<Creature*> SERIAL(creatures);
   Model* SERIAL2(model, nullptr);
   mutable unordered_map<Vision*, FieldOfView> SERIAL(fieldOfView);
@@ -271,6 +290,8 @@ class Level {
   Vec2 SERIAL(backgroundOffset);
   Table<CoverInfo> SERIAL(coverInfo);
   Table<double> SERIAL(lightAmount);
+  bool SERIAL2(active, true);
+  double SERIAL2(dormantTime, 0);
   
   Level(Table<PSquare> s, Model*, vector<Location*>, const string& message, const string& name,
       Table<CoverInfo> coverInfo);
@@ -282,6 +303,7 @@ class Level {
 
   /** Notify relevant locations about creature position. */
   void notifyLocations(Creature*);
+  void updateLocationGrid() const;
 };
 
 #endif
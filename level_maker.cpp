@@ -171,7 +171,7 @@ class RoomMaker : public LevelMaker {
           }
       } while (!good && --cnt > 0);
       if (cnt == 0) {
-        Debug() << "Placed only " << i << " rooms out of " << numRooms;
+        LOG << "Placed only " << i << " rooms out of " << numRooms;
         break;
       }
       for (Vec2 v : Rectangle(k))
@@ -439,7 +439,7 @@ class River : public LevelMaker {
   private:
 
   vector<Vec2> straightLine(int x0, int y0, int x1, int y1){
-    Debug() << "Line " << x1 << " " << y0 << " " << x1 << " " << y1;
+    LOG << "Line " << x1 << " " << y0 << " " << x1 << " " << y1;
     int dx = x1 - x0;
     int dy = y1 - y0;
     vector<Vec2> ret{ Vec2(x0, y0)};
@@ -941,10 +941,10 @@ class Shrine : public LevelMaker {
           builder->putSquare(fl, newWall);
       if (locationMaker)
         locationMaker->make(builder, Rectangle(pos - Vec2(1, 1), pos + Vec2(2, 2)));
-      Debug() << "Created a shrine of " << deity->getHabitatString();
+      LOG << "Created a shrine of " << deity->getHabitatString();
       return;
     }
-    Debug() << "Didn't find a good place for the shrine of " << deity->getHabitatString();
+    LOG << "Didn't find a good place for the shrine of " << deity->getHabitatString();
   }
 
   private:
@@ -1030,7 +1030,7 @@ vector<double> sortedValues(const Table<double>& t) {
     string out;
     for (double d : values)
       out.append(convertToString(d) + " ");
-    Debug() << (int)tmp.size() << " unique values out of " << (int)values.size() << " " << out;*/
+    LOG << (int)tmp.size() << " unique values out of " << (int)values.size() << " " << out;*/
   return values;
 }
 
@@ -1092,7 +1092,7 @@ class Mountains : public LevelMaker {
         ++wCnt;
       }
     }
-    Debug() << "Terrain distribution " << gCnt << " glacier, " << mCnt << " mountain, " << hCnt << " hill, " << lCnt << " lowland, " << wCnt << " water, " << sCnt << " sand";
+    LOG << "Terrain distribution " << gCnt << " glacier, " << mCnt << " mountain, " << hCnt << " hill, " << lCnt << " lowland, " << wCnt << " water, " << sCnt << " sand";
   }
 
   private:
@@ -1123,7 +1123,7 @@ class Roads : public LevelMaker {
     for (Vec2 v : area)
       if (builder->hasAttrib(v, SquareAttrib::CONNECT_ROAD)) {
         points.push_back(v);
-        Debug() << "Connecting point " << v;
+        LOG << "Connecting point " << v;
       }
     for (int ind : Range(1, points.size())) {
       Vec2 p1 = points[ind];
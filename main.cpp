@@ -37,6 +37,7 @@
 #include "gui_elem.h"
 #include "music.h"
 #include "test.h"
+#include "profiler.h"
 
 using namespace boost::iostreams;
 
@@ -110,6 +111,7 @@ static Optional<string> chooseSaveFile(vector<pair<GameType, string>> games, str
 static unique_ptr<Model> loadGame(const string& filename, bool eraseFile) {
   unique_ptr<Model> model;
   {
+    PROFILE("load game");
     igzstream ifs(filename.c_str());
     CHECK(ifs.good()) << "File not found: " << filename;
     filtering_streambuf<input> in;
@@ -129,6 +131,7 @@ static unique_ptr<Model> loadGame(const string& filename, bool eraseFile) {
 }
 
 static void saveGame(unique_ptr<Model> model, const string& filename) {
+  PROFILE("save game");
   ogzstream ofs(filename.c_str());
   boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
   out.push(ofs);
@@ -164,6 +167,10 @@ int main(int argc, char* argv[]) {
   string lognamePref = "log";
   Debug::init();
   Options::init("options.txt");
+#ifndef RELEASE
+  Debug::setLogging(Options::getValue(OptionId::LOGGING));
+  Options::addTrigger(OptionId::LOGGING, [](bool on) { Debug::setLogging(on); });
+#endif
   int seed = time(0);
   int forceMode = -1;
   bool genExit = false;
@@ -187,11 +194,11 @@ int main(int argc, char* argv[]) {
     fname += convertToString(seed);
     output.open(fname);
     CHECK(output.is_open());
-    Debug() << "Writing to " << fname;
+    LOG << "Writing to " << fname;
     view.reset(View::createLoggingView(output));
   } else {
     string fname = argv[1];
-    Debug() << "Reading from " << fname;
+    LOG << "Reading from " << fname;
     seed = convertFromString<int>(fname.substr(lognamePref.size()));
     Random.init(seed);
     input.open(fname);
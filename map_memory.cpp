@@ -41,10 +41,46 @@ void MapMemory::addObject(Vec2 pos, const ViewObject& obj) {
   table[pos]->addHighlight(HighlightType::MEMORY);
 }
 
+static const vector<ViewLayer> memoryLayers {
+    ViewLayer::ITEM, ViewLayer::FLOOR_BACKGROUND, ViewLayer::FLOOR, ViewLayer::LARGE_ITEM};
+
+// checks if update() would store the same objects and highlights that are already remembered
+bool MapMemory::isUpToDate(Vec2 pos, const ViewIndex& index) const {
+  if (!table[pos])
+    return false;
+  const ViewIndex& memory = *table[pos];
+  for (ViewLayer l : memoryLayers)
+    if (index.hasObject(l) != memory.hasObject(l)
+        || (index.hasObject(l) && !(index.getObject(l) == memory.getObject(l))))
+      return false;
+  vector<ViewIndex::HighlightInfo> highlight = index.getHighlight();
+  vector<ViewIndex::HighlightInfo> remembered = memory.getHighlight();
+  bool hasMemory = false;
+  for (auto& elem : highlight) {
+    double amount = elem.amount;
+    if (elem.type == HighlightType::MEMORY) {
+      hasMemory = true;
+      amount = 1;
+    }
+    bool found = false;
+    for (auto& rem : remembered)
+      if (rem.type == elem.type) {
+        if (rem.amount != amount)
+          return false;
+        found = true;
+      }
+    if (!found)
+      return false;
+  }
+  return remembered.size() == highlight.size() + (hasMemory ? 0 : 1);
+}
+
 void MapMemory::update(Vec2 pos, const ViewIndex& index) {
+  if (isUpToDate(pos, index))
+    return;
   table[pos] = ViewIndex();
   table[pos]->addHighlight(HighlightType::MEMORY);
-  for (ViewLayer l : { ViewLayer::ITEM, ViewLayer::FLOOR_BACKGROUND, ViewLayer::FLOOR, ViewLayer::LARGE_ITEM})
+  for (ViewLayer l : memoryLayers)
     if (index.hasObject(l))
       addObject(pos, index.getObject(l));
   for (auto highlight : index.getHighlight())
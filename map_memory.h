@@ -37,6 +37,7 @@ class MapMemory {
   SERIAL_CHECKER;
 
   private:
+  bool isUpToDate(Vec2, const ViewIndex&) const;
   Table<Optional<ViewIndex>> SERIAL(table);
 };
 
@@ -37,7 +37,7 @@ void correct(string& msg) {
 }
 
 void MessageBuffer::addMessage(string msg) {
-  Debug() << "MSG " << msg;
+  LOG << "MSG " << msg;
   CHECK(view != nullptr) << "Message buffer not initialized.";
   if (msg == "")
     return;
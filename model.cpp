@@ -25,6 +25,7 @@
 #include "options.h"
 #include "task.h"
 #include "technology.h"
+#include "profiler.h"
 
 template <class Archive> 
 void Model::serialize(Archive& ar, const unsigned int version) { 
@@ -37,7 +38,8 @@ void Model::serialize(Archive& ar, const unsigned int version) {
     & SVAR(collective)
     & SVAR(won)
     & SVAR(addHero)
-    & SVAR(adventurer);
+    & SVAR(adventurer)
+    & SVAR(lastVisited);
   CHECK_SERIAL;
   Skill::serializeAll(ar);
   Deity::serializeAll(ar);
@@ -121,24 +123,28 @@ void Model::update(double totalTime) {
   }
   if (collective) {
     collective->render(view);
+    if (!collective->isTurnBased()) {
+      PROFILE("input polling");
+      pollInput();
+    }
   }
   do {
     Creature* creature = timeQueue.getNextCreature();
     CHECK(creature) << "No more creatures";
-    Debug() << creature->getTheName() << " moving now " << creature->getTime();
+    LOG << creature->getTheName() << " moving now " << creature->getTime();
     currentTime = creature->getTime();
-    if (collective && !collective->isTurnBased()) {
-      while (1) {
-        UserInput input = view->getAction();
-        if (input.type == UserInput::IDLE)
-          break;
-        collective->processInput(view, input);
-      }
-    }
-    if (currentTime > totalTime)
+    if (currentTime > totalTime) {
+      // input from frames that didn't reach the next turn, e.g. while the game is paused
+      processInput();
       return;
+    }
     if (currentTime >= lastTick + 1) {
-      MEASURE({ tick(currentTime); }, "ticking time");
+      processInput();
+      tick(currentTime);
+    }
+    if (!creature->getLevel()->isActive()) {
+      timeQueue.suspendCreature(creature);
+      continue;
     }
     bool unpossessed = false;
     if (!creature->isDead()) {
@@ -172,15 +178,34 @@ void Model::update(double totalTime) {
   } while (1);
 }
 
+void Model::pollInput() {
+  while (1) {
+    UserInput input = view->getAction();
+    if (input.type == UserInput::IDLE)
+      break;
+    inputQueue.push(input);
+  }
+}
+
+void Model::processInput() {
+  UserInput input;
+  while (inputQueue.pop(input))
+    collective->processInput(view, input);
+}
+
 void Model::tick(double time) {
+  Profiler::endTurn();
+  PROFILE("model tick");
   updateSunlightInfo();
-  Debug() << "Turn " << time;
-  for (Creature* c : timeQueue.getAllCreatures()) {
-    c->tick(time);
-  }
+  LOG << "Turn " << time;
+  updateLevelActivity(time);
+  Creature::timeOutEffects(time);
+  for (Creature* c : timeQueue.getAllCreatures())
+    if (c->getLevel()->isActive())
+      c->tick(time);
   for (PLevel& l : levels)
-    for (Square* square : l->getTickingSquares())
-      square->tick(time);
+    if (l->isActive())
+      l->tickSquares(time);
   lastTick = time;
   if (collective) {
     collective->tick();
@@ -198,6 +223,47 @@ void Model::tick(double time) {
   }
 }
 
+const double dormantDelay = 50;
+
+bool Model::isVisited(const Level* l) const {
+  if (l->getPlayer() || (collective && collective->getLevel() == l))
+    return true;
+  if (collective)
+    for (const Creature* c : l->getAllCreatures())
+      if (c->getTribe() == collective->getTribe())
+        return true;
+  return false;
+}
+
+void Model::updateLevelActivity(double time) {
+  for (PLevel& l : levels) {
+    if (isVisited(l.get()))
+      lastVisited[l.get()] = time;
+    if (!l->isActive()) {
+      if (lastVisited[l.get()] == time)
+        wakeUpLevel(l.get());
+    } else if (time - lastVisited[l.get()] > dormantDelay) {
+      LOG << "Level " << l->getName() << " is dormant";
+      l->setDormant(time);
+    }
+  }
+}
+
+void Model::wakeUpLevel(Level* l) {
+  LOG << "Waking up level " << l->getName();
+  lastVisited[l] = currentTime;
+  l->wakeUp(currentTime);
+  vector<Creature*> creatures = l->getAllCreatures();
+  for (Creature* c : creatures)
+    if (!c->isDead()) {
+      if (c->getTime() < currentTime)
+        c->setTime(currentTime);
+      timeQueue.resumeCreature(c);
+      c->catchUp(currentTime);
+      c->tick(currentTime);
+    }
+}
+
 void Model::addCreature(PCreature c) {
   c->setTime(timeQueue.getCurrentTime() + 1);
   timeQueue.addCreature(std::move(c));
@@ -441,6 +507,10 @@ string Model::getGameIdentifier() const {
     return *NOTNULL(getPlayer())->getFirstName();
 }
 
+vector<EventId> Model::getSubscribedEvents() const {
+  return {EventId::KILL};
+}
+
 void Model::onKillEvent(const Creature* victim, const Creature* killer) {
   if (collective && collective->isRetired() && victim == collective->getKeeper()) {
     const Creature* c = getPlayer();
@@ -629,6 +699,8 @@ Vec2 Model::changeLevel(StairDirection dir, StairKey key, Creature* c) {
     current->updatePlayer();
     target->updatePlayer();
   }
+  if (!target->isActive())
+    wakeUpLevel(target);
   return newPos;
 }
 
@@ -639,6 +711,8 @@ void Model::changeLevel(Level* target, Vec2 position, Creature* c) {
     current->updatePlayer();
     target->updatePlayer();
   }
+  if (!target->isActive())
+    wakeUpLevel(target);
 }
   
 void Model::conquered(const string& title, const string& land, vector<const Creature*> kills, int points) {
@@ -25,6 +25,7 @@
 #include "village_control.h"
 #include "collective.h"
 #include "encyclopedia.h"
+#include "input_queue.h"
 
 class Collective;
 
@@ -71,6 +72,7 @@ class Model : public EventListener {
   void setView(View*);
 
   void tick(double time);
+  vector<EventId> getSubscribedEvents() const override;
   void onKillEvent(const Creature* victim, const Creature* killer) override;
   void gameOver(const Creature* player, int numKills, const string& enemiesString, int points);
   void conquered(const string& title, const string& land, vector<const Creature*> kills, int points);
@@ -94,6 +96,14 @@ class Model : public EventListener {
 
   private:
   void updateSunlightInfo();
+  /** Puts levels with no player or minions on them to sleep and wakes up the ones that are visited again.*/
+  void updateLevelActivity(double time);
+  bool isVisited(const Level*) const;
+  void wakeUpLevel(Level*);
+  /** Collects all pending user input once per frame. */
+  void pollInput();
+  /** Applies input collected by pollInput() to the collective. Called at turn boundaries and when a frame ends. */
+  void processInput();
   PCreature makePlayer();
   const Creature* getPlayer() const;
   void landHeroPlayer();
@@ -114,7 +124,9 @@ class Model : public EventListener {
   bool SERIAL2(addHero, false);
   bool SERIAL2(adventurer, false);
   double SERIAL2(currentTime, 0);
+  map<const Level*, double> SERIAL(lastVisited);
   SunlightInfo sunlightInfo;
+  InputQueue inputQueue;
 };
 
 #endif
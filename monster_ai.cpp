@@ -21,6 +21,7 @@
 #include "collective.h"
 #include "village_control.h"
 #include "task.h"
+#include "profiler.h"
 
 template <class Archive> 
 void MonsterAI::serialize(Archive& ar, const unsigned int version) {
@@ -59,7 +60,7 @@ const Creature* Behaviour::getClosestEnemy() {
 Item* Behaviour::getBestWeapon() {
   Item* best = nullptr;
   int damage = -1;
-  for (Item* item : creature->getEquipment().getItems(Item::typePredicate(ItemType::WEAPON))) 
+  for (Item* item : creature->getEquipment().getItems(ItemType::WEAPON))
     if (item->getModifier(AttrType::DAMAGE) > damage) {
       damage = item->getModifier(AttrType::DAMAGE);
       best = item;
@@ -131,6 +132,10 @@ class Heal : public Behaviour {
     CHECK_SERIAL;
   }
 
+  virtual const char* getName() const override {
+    return "heal";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Heal);
 
   private:
@@ -155,6 +160,10 @@ class Rest : public Behaviour {
     return {0.1, creature->wait() };
   }
 
+  virtual const char* getName() const override {
+    return "rest";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Rest);
 
   template <class Archive>
@@ -205,6 +214,10 @@ class MoveRandomly : public Behaviour {
     return contains(memory, pos);
   }
 
+  virtual const char* getName() const override {
+    return "move randomly";
+  }
+
   SERIALIZATION_CONSTRUCTOR(MoveRandomly);
 
   template <class Archive>
@@ -240,6 +253,10 @@ class AttackPest : public Behaviour {
       return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "attack pest";
+  }
+
   SERIALIZATION_CONSTRUCTOR(AttackPest);
 
   template <class Archive>
@@ -260,6 +277,10 @@ class BirdFlyAway : public Behaviour {
     return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "bird fly away";
+  }
+
   SERIALIZATION_CONSTRUCTOR(BirdFlyAway);
 
   template <class Archive>
@@ -283,6 +304,10 @@ class GoldLust : public Behaviour {
       return 0;
   }
 
+  virtual const char* getName() const override {
+    return "gold lust";
+  }
+
   SERIALIZATION_CONSTRUCTOR(GoldLust);
 
   template <class Archive>
@@ -300,6 +325,10 @@ class Fighter : public Behaviour, public EventListener {
   virtual ~Fighter() {
   }
 
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return {EventId::KILL, EventId::THROW};
+  }
+
   virtual void onKillEvent(const Creature* victim, const Creature* killer) override {
     if (victim != creature && victim->getName() == creature->getName() && creature->canSee(victim)) {
       courage -= 0.1;
@@ -343,7 +372,7 @@ class Fighter : public Behaviour, public EventListener {
         weight = 1;
       if (other->isAffected(LastingEffect::SLEEP) || other->isStationary())
         weight = 0;
-      Debug() << creature->getName() << " panic weight " << weight;
+      LOG << creature->getName() << " panic weight " << weight;
       if (weight >= 0.5) {
         double dist = creature->getPosition().dist8(other->getPosition());
         if (dist < 7) {
@@ -478,7 +507,7 @@ class Fighter : public Behaviour, public EventListener {
     CHECK(other);
     if (other->isInvincible())
       return NoMove;
-    Debug() << creature->getName() << " enemy " << other->getName();
+    LOG << creature->getName() << " enemy " << other->getName();
     Vec2 enemyDir = (other->getPosition() - creature->getPosition());
     distance = enemyDir.length8();
     if (creature->isHumanoid() && !creature->getEquipment().getItem(EquipmentSlot::WEAPON)) {
@@ -522,6 +551,10 @@ class Fighter : public Behaviour, public EventListener {
     return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "fighter";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Fighter);
 
   template <class Archive>
@@ -558,6 +591,10 @@ class GuardTarget : public Behaviour {
   public:
   GuardTarget(Creature* c, double minD, double maxD) : Behaviour(c), minDist(minD), maxDist(maxD) {}
 
+  virtual const char* getName() const override {
+    return "guard target";
+  }
+
   SERIALIZATION_CONSTRUCTOR(GuardTarget);
 
   template <class Archive>
@@ -603,6 +640,10 @@ class GuardArea : public Behaviour {
     return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "guard area";
+  }
+
   SERIALIZATION_CONSTRUCTOR(GuardArea);
 
   template <class Archive>
@@ -624,6 +665,10 @@ class GuardSquare : public GuardTarget {
     return getMoveTowards(pos);
   }
 
+  virtual const char* getName() const override {
+    return "guard square";
+  }
+
   SERIALIZATION_CONSTRUCTOR(GuardSquare);
 
   template <class Archive>
@@ -644,6 +689,10 @@ class Wait : public Behaviour {
     return {1.0, creature->wait()};
   }
 
+  virtual const char* getName() const override {
+    return "wait";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Wait);
 
   template <class Archive>
@@ -672,6 +721,10 @@ class DoorEater : public Behaviour {
     return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "door eater";
+  }
+
   SERIALIZATION_CONSTRUCTOR(DoorEater);
 
   template <class Archive>
@@ -689,6 +742,10 @@ class Summoned : public GuardTarget, public EventListener {
   virtual ~Summoned() {
   }
 
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return {EventId::CHANGE_LEVEL};
+  }
+
   virtual void onChangeLevelEvent(const Creature* c, const Level* from,
       Vec2 pos, const Level* to, Vec2 toPos) override {
     if (c == target)
@@ -716,6 +773,10 @@ class Summoned : public GuardTarget, public EventListener {
       return getMoveTowards(stairs);
   }
 
+  virtual const char* getName() const override {
+    return "summoned";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Summoned);
 
   template <class Archive>
@@ -767,6 +828,10 @@ class Thief : public Behaviour {
     return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "thief";
+  }
+
   SERIALIZATION_CONSTRUCTOR(Thief);
 
   template <class Archive>
@@ -787,6 +852,10 @@ class ByCollective : public Behaviour {
     return collective->getMove(creature);
   }
 
+  virtual const char* getName() const override {
+    return "by collective";
+  }
+
   SERIALIZATION_CONSTRUCTOR(ByCollective);
 
   template <class Archive>
@@ -807,6 +876,10 @@ class ChooseRandom : public Behaviour {
     return chooseRandom(behaviours, weights)->getMove();
   }
 
+  virtual const char* getName() const override {
+    return "choose random";
+  }
+
   SERIALIZATION_CONSTRUCTOR(ChooseRandom);
 
   template <class Archive>
@@ -831,6 +904,10 @@ class GoToHeart : public Behaviour {
       return NoMove;
   };
 
+  virtual const char* getName() const override {
+    return "go to heart";
+  }
+
   SERIALIZATION_CONSTRUCTOR(GoToHeart);
 
   template <class Archive>
@@ -860,6 +937,10 @@ class ByVillageControl : public Behaviour {
       return NoMove;
   }
 
+  virtual const char* getName() const override {
+    return "by village control";
+  }
+
   SERIALIZATION_CONSTRUCTOR(ByVillageControl);
 
   template <class Archive>
@@ -905,19 +986,36 @@ MonsterAI::MonsterAI(Creature* c, const vector<Behaviour*>& beh, const vector<in
 }
 
 void MonsterAI::makeMove() {
-  vector<pair<MoveInfo, int>> moves;
-  for (int i : All(behaviours)) {
+  PROFILE("monster AI");
+  if (byWeight.size() != behaviours.size()) {
+    byWeight.clear();
+    for (int i : All(behaviours))
+      byWeight.push_back(i);
+    stable_sort(byWeight.begin(), byWeight.end(), [this](int a, int b) { return weights[a] > weights[b]; });
+  }
+  vector<vector<Item*>> pickUpOptions;
+  if (pickItems) {
+    vector<Item*> items = creature->getPickUpOptions();
+    if (!items.empty())
+      for (auto elem : Item::stackItems(items))
+        if (!elem.second[0]->getShopkeeper() && creature->pickUp(elem.second))
+          pickUpOptions.push_back(elem.second);
+  }
+  // A behaviour's move is worth at most its weight, so once the best move is worth at least the weight
+  // of the next behaviour, none of the remaining ones can beat it.
+  MoveInfo winner = NoMove;
+  for (int i : byWeight) {
+    if (winner.value >= weights[i])
+      break;
+    ProfileZone zone(behaviours[i]->getName());
     MoveInfo move = behaviours[i]->getMove();
     move.value *= weights[i];
-    moves.emplace_back(move, weights[i]);
-    if (pickItems) {
-      for (auto elem : Item::stackItems(creature->getPickUpOptions())) {
-        Item* item = elem.second[0];
-        if (!item->getShopkeeper() && creature->pickUp(elem.second))
-          moves.emplace_back(
-              MoveInfo({ behaviours[i]->itemValue(item) * weights[i], creature->pickUp(elem.second)}),
-              weights[i]);
-      }
+    if (move.value > winner.value)
+      winner = move;
+    for (auto& items : pickUpOptions) {
+      double value = behaviours[i]->itemValue(items[0]) * weights[i];
+      if (value > winner.value)
+        winner = {value, creature->pickUp(items)};
     }
   }
   /*vector<Item*> inventory = creature->getEquipment().getItems([this](Item* item) { return !creature->getEquipment().isEquiped(item);});
@@ -931,14 +1029,6 @@ void MonsterAI::makeMove() {
         creature->drop({item});
       }});
   }*/
-  MoveInfo winner = NoMove;
-  for (int i : All(moves)) {
-    MoveInfo& move = moves[i].first;
-    if (move.value > winner.value)
-      winner = move;
-    if (i < moves.size() - 1 && move.value > moves[i + 1].second)
-      break;
-  }
   CHECK(winner.value > 0);
   winner.move.perform();
 }
@@ -49,6 +49,8 @@ class Behaviour {
   virtual MoveInfo getMove() { return NoMove; }
   virtual void onAttacked(const Creature* attacker) {}
   virtual double itemValue(const Item*) { return 0; }
+  /** Returns a name for profiling, which must be a string literal.*/
+  virtual const char* getName() const = 0;
   Item* getBestWeapon();
   const Creature* getClosestEnemy();
   MoveInfo tryToApplyItem(EffectType, double maxTurns);
@@ -77,6 +79,7 @@ class MonsterAI {
   vector<int> SERIAL(weights);
   Creature* SERIAL(creature);
   bool SERIAL(pickItems);
+  vector<int> byWeight;
 };
 
 class Collective;
@@ -23,6 +23,7 @@ const unordered_map<OptionId, int> defaults {
   {OptionId::ASCII, 0},
   {OptionId::MUSIC, 1},
   {OptionId::KEEP_SAVEFILES, 0},
+  {OptionId::LOGGING, 1},
   {OptionId::SHOW_MAP, 0},
   {OptionId::START_WITH_NIGHT, 0},
   {OptionId::EASY_KEEPER, 1},
@@ -35,6 +36,7 @@ const map<OptionId, string> names {
   {OptionId::ASCII, "Unicode graphics"},
   {OptionId::MUSIC, "Music"},
   {OptionId::KEEP_SAVEFILES, "Keep save files"},
+  {OptionId::LOGGING, "Write log"},
   {OptionId::SHOW_MAP, "Show map"},
   {OptionId::START_WITH_NIGHT, "Start with night"},
   {OptionId::EASY_KEEPER, "Game difficulty"},
@@ -47,7 +49,10 @@ const map<OptionSet, vector<OptionId>> optionSets {
       OptionId::HINTS,
       OptionId::ASCII,
       OptionId::MUSIC,
-      OptionId::KEEP_SAVEFILES
+      OptionId::KEEP_SAVEFILES,
+#ifndef RELEASE
+      OptionId::LOGGING,
+#endif
   }},
   {OptionSet::KEEPER, {
       OptionId::EASY_KEEPER,
@@ -91,6 +96,7 @@ unordered_map<OptionId, vector<string>> valueNames {
   {OptionId::ASCII, { "off", "on" }},
   {OptionId::MUSIC, { "off", "on" }},
   {OptionId::KEEP_SAVEFILES, { "no", "yes" }},
+  {OptionId::LOGGING, { "off", "on" }},
   {OptionId::SHOW_MAP, { "no", "yes" }},
   {OptionId::START_WITH_NIGHT, { "no", "yes" }},
   {OptionId::EASY_KEEPER, { "hard", "easy" }},
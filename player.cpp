@@ -49,6 +49,10 @@ Player::Player(Creature* c, Model* m, bool greet, map<Level*, MapMemory>* memory
 Player::~Player() {
 }
 
+vector<EventId> Player::getSubscribedEvents() const {
+  return {EventId::THROW, EventId::EXPLOSION, EventId::ALARM};
+}
+
 const Level* Player::getListenerLevel() const {
   return creature->getLevel();
 }
@@ -453,7 +457,7 @@ void Player::travelAction() {
   vector<Vec2> squareDirs = creature->getConstSquare()->getTravelDir();
   if (squareDirs.size() != 2) {
     travelling = false;
-    Debug() << "Stopped by multiple routes";
+    LOG << "Stopped by multiple routes";
     return;
   }
   Optional<int> myIndex = findElement(squareDirs, -travelDir);
@@ -488,7 +492,7 @@ void Player::payDebtAction() {
           creature->give(c, gold);
         }
       } else {
-        Debug() << "No debt " << c->getName();
+        LOG << "No debt " << c->getName();
       }
     }
 }
@@ -536,9 +540,7 @@ void Player::sleeping() {
     ViewObject::setHallu(true);
   else
     ViewObject::setHallu(false);
-  MEASURE(
-      model->getView()->refreshView(creature),
-      "level render time");
+  model->getView()->refreshView(creature);
 }
 
 static bool displayTravelInfo = true;
@@ -563,9 +565,7 @@ void Player::makeMove() {
     ViewObject::setHallu(true);
   else
     ViewObject::setHallu(false);
-  MEASURE(
-      model->getView()->refreshView(creature),
-      "level render time");
+  model->getView()->refreshView(creature);
   if (Options::getValue(OptionId::HINTS) && displayTravelInfo && creature->getConstSquare()->getName() == "road") {
     model->getView()->presentText("", "Use ctrl + arrows to travel quickly on roads and corridors.");
     displayTravelInfo = false;
@@ -592,7 +592,7 @@ void Player::makeMove() {
     targetAction();
   else {
     UserInput action = model->getView()->getAction();
-    Debug() << "Action " << int(action.type);
+    LOG << "Action " << int(action.type);
   vector<Vec2> direction;
   bool travel = false;
   if (action.type != UserInput::IDLE)
@@ -778,6 +778,10 @@ class PossessedController : public Player {
       owner->popController();
   }
 
+  vector<EventId> getSubscribedEvents() const override {
+    return concat(Player::getSubscribedEvents(), {EventId::ATTACK});
+  }
+
   void onAttackEvent(const Creature* victim, const Creature* attacker) override {
     if (!creature->isDead() && victim == owner)
       unpossess();
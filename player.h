@@ -51,6 +51,7 @@ class Player : public Controller, public EventListener {
   
   virtual Controller* getPossessedController(Creature* c) override;
 
+  virtual vector<EventId> getSubscribedEvents() const override;
   virtual const Level* getListenerLevel() const override;
   virtual void onThrowEvent(const Creature* thrower, const Item* item, const vector<Vec2>& trajectory) override;
   virtual void onExplosionEvent(const Level* level, Vec2 pos) override;
@@ -53,6 +53,12 @@ void PoisonGas::tick(Level* level, Vec2 pos) {
   amount = max(0.0, amount - decrease);
 }
 
+void PoisonGas::catchUp(double turns) {
+  amount = max(0.0, amount - decrease * turns);
+  if (amount < 0.1)
+    amount = 0;
+}
+
 double PoisonGas::getAmount() const {
   return amount;
 }
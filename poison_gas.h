@@ -24,6 +24,8 @@ class PoisonGas {
   public:
   void addAmount(double amount);
   void tick(Level*, Vec2 pos);
+  /** Dissipates the gas by the given number of turns at once, without spreading it.*/
+  void catchUp(double turns);
   double getAmount() const;
 
   template <class Archive> 
@@ -0,0 +1,186 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <mutex>
+#include <iomanip>
+
+#include "profiler.h"
+
+namespace {
+
+long long getNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ZoneRecord {
+  const char* name;
+  int depth;
+  long long start;
+  long long duration;
+};
+
+const int bufferSize = 1 << 16;
+
+struct ThreadBuffer {
+  ThreadBuffer(int i) : records(bufferSize), id(i) {}
+
+  vector<ZoneRecord> records;
+  long long numRecords = 0;
+  long long turnMark = 0;
+  long long frameMark = 0;
+  int depth = 0;
+  int id;
+  std::mutex recordsMutex;
+};
+
+std::mutex buffersMutex;
+vector<unique_ptr<ThreadBuffer>> buffers;
+
+ThreadBuffer& getBuffer() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.emplace_back(new ThreadBuffer(buffers.size()));
+    buffer = buffers.back().get();
+  }
+  return *buffer;
+}
+
+map<string, Profiler::Stats> aggregate(ThreadBuffer& buffer, long long& mark) {
+  map<string, vector<long long>> times;
+  {
+    std::lock_guard<std::mutex> lock(buffer.recordsMutex);
+    unordered_map<const char*, vector<long long>> byName;
+    for (long long i = max(mark, buffer.numRecords - bufferSize); i < buffer.numRecords; ++i) {
+      const ZoneRecord& record = buffer.records[i % bufferSize];
+      byName[record.name].push_back(record.duration);
+    }
+    mark = buffer.numRecords;
+    for (auto& elem : byName)
+      append(times[elem.first], elem.second);
+  }
+  map<string, Profiler::Stats> ret;
+  for (auto& elem : times) {
+    vector<long long>& t = elem.second;
+    sort(t.begin(), t.end());
+    double sum = 0;
+    for (long long d : t)
+      sum += d;
+    ret[elem.first] = {int(t.size()), sum / t.size() / 1000, double(t[(t.size() - 1) * 95 / 100]) / 1000,
+        double(t.back()) / 1000};
+  }
+  return ret;
+}
+
+map<string, Profiler::Stats> turnStats;
+map<string, Profiler::Stats> frameStats;
+
+}
+
+#ifdef RELEASE
+bool Profiler::enabled = false;
+#else
+bool Profiler::enabled = true;
+#endif
+
+ProfileZone::ProfileZone(const char* n) : name(n), start(-1) {
+  if (Profiler::enabled) {
+    ++getBuffer().depth;
+    start = getNanoseconds();
+  }
+}
+
+ProfileZone::~ProfileZone() {
+  if (start < 0)
+    return;
+  long long end = getNanoseconds();
+  ThreadBuffer& buffer = getBuffer();
+  --buffer.depth;
+  std::lock_guard<std::mutex> lock(buffer.recordsMutex);
+  buffer.records[buffer.numRecords % bufferSize] = {name, buffer.depth, start, end - start};
+  ++buffer.numRecords;
+}
+
+void Profiler::setEnabled(bool state) {
+  enabled = state;
+}
+
+bool Profiler::isEnabled() {
+  return enabled;
+}
+
+void Profiler::endTurn() {
+  ThreadBuffer& buffer = getBuffer();
+  turnStats = aggregate(buffer, buffer.turnMark);
+}
+
+void Profiler::endFrame() {
+  ThreadBuffer& buffer = getBuffer();
+  frameStats = aggregate(buffer, buffer.frameMark);
+}
+
+const map<string, Profiler::Stats>& Profiler::getTurnStats() {
+  return turnStats;
+}
+
+const map<string, Profiler::Stats>& Profiler::getFrameStats() {
+  return frameStats;
+}
+
+vector<string> Profiler::getOverlay(const map<string, Stats>& stats) {
+  vector<pair<string, Stats>> zones(stats.begin(), stats.end());
+  sort(zones.begin(), zones.end(), [](const pair<string, Stats>& a, const pair<string, Stats>& b) {
+      return a.second.mean * a.second.count > b.second.mean * b.second.count; });
+  vector<string> ret;
+  for (auto& elem : zones)
+    ret.push_back(elem.first + " x" + convertToString(elem.second.count)
+        + " mean " + convertToString(int(elem.second.mean))
+        + " p95 " + convertToString(int(elem.second.p95))
+        + " max " + convertToString(int(elem.second.max)));
+  return ret;
+}
+
+void Profiler::writeTrace(const string& path) {
+  ofstream out(path);
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  for (auto& buffer : buffers) {
+    std::lock_guard<std::mutex> lock(buffer->recordsMutex);
+    for (long long i = max(0LL, buffer->numRecords - bufferSize); i < buffer->numRecords; ++i) {
+      const ZoneRecord& record = buffer->records[i % bufferSize];
+      if (!first)
+        out << ",";
+      first = false;
+      out << "\n{\"name\":\"" << record.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->id
+          << ",\"ts\":" << double(record.start) / 1000 << ",\"dur\":" << double(record.duration) / 1000 << "}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+void Profiler::clear() {
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  for (auto& buffer : buffers) {
+    std::lock_guard<std::mutex> lock(buffer->recordsMutex);
+    buffer->numRecords = buffer->turnMark = buffer->frameMark = 0;
+  }
+  turnStats.clear();
+  frameStats.clear();
+}
@@ -0,0 +1,72 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include "util.h"
+
+/** Times the rest of the enclosing scope as a zone called \paramname{name}, which must be a string
+    literal or otherwise outlive the profiler.*/
+#define PROFILE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_CONCAT2(a, b) a##b
+
+class ProfileZone {
+  public:
+  ProfileZone(const char* name);
+  ~ProfileZone();
+
+  private:
+  const char* name;
+  long long start;
+};
+
+/** Collects the zones closed on each thread in a fixed size ring buffer. Zones nest, and their times
+    are aggregated per game turn and per rendered frame. Times are in microseconds.*/
+class Profiler {
+  public:
+  struct Stats {
+    int count;
+    double mean;
+    double p95;
+    double max;
+  };
+
+  static void setEnabled(bool);
+  static bool isEnabled();
+
+  /** Aggregates the zones closed on the calling thread since the previous call.*/
+  static void endTurn();
+  /** Like endTurn(), for the frames. Only needs to be called while the frame stats are displayed.*/
+  static void endFrame();
+  static const map<string, Stats>& getTurnStats();
+  static const map<string, Stats>& getFrameStats();
+
+  /** Returns one line per zone, slowest first, for displaying on screen.*/
+  static vector<string> getOverlay(const map<string, Stats>&);
+
+  /** Writes the zones still in the buffers of all threads in the Chrome trace event format.*/
+  static void writeTrace(const string& path);
+
+  /** Forgets all recorded zones.*/
+  static void clear();
+
+  private:
+  friend class ProfileZone;
+  static bool enabled;
+};
+
+#endif
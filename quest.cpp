@@ -48,6 +48,10 @@ class KillTribeQuest : public Quest, public EventListener {
     return true;
   }
 
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return {EventId::KILL};
+  }
+
   virtual void onKillEvent(const Creature* member, const Creature* attacker) {
     if (isFinished() && !notified) {
       notified = true;
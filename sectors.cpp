@@ -52,7 +52,7 @@ void Sectors::add(Vec2 pos) {
         largest = elem;
     join(pos, largest);
   }
-  Debug() << "Sectors " << vector<int>(neighbors.begin(), neighbors.end())
+  LOG << "Sectors " << vector<int>(neighbors.begin(), neighbors.end())
     << " joined " << sectors[pos] << " size " << sizes[sectors[pos]];
 }
 
@@ -97,7 +97,7 @@ void Sectors::remove(Vec2 pos) {
       join(v, getNewSector());
       newSizes.push_back(sizes[sectors[v]]);
     }
-  Debug() << "Sectors size " << curNumber << " split into " << newSizes;
+  LOG << "Sectors size " << curNumber << " split into " << newSizes;
 }
 
 using namespace std;
@@ -230,16 +230,16 @@ inline void serialize(Archive& ar, stack<T>& t, unsigned int file_version){
 }
 
 //unordered_set
-template<class Archive, class T>
-inline void save(Archive& ar, const unordered_set<T>& t, unsigned int file_version){
+template<class Archive, class T, class H>
+inline void save(Archive& ar, const unordered_set<T, H>& t, unsigned int file_version){
   int count = t.size();
   ar << BOOST_SERIALIZATION_NVP(count);
   for (auto elem : t)
     ar << boost::serialization::make_nvp("item", elem);
 }
 
-template<class Archive, class T>
-inline void load(Archive& ar, unordered_set<T>& t, unsigned int){
+template<class Archive, class T, class H>
+inline void load(Archive& ar, unordered_set<T, H>& t, unsigned int){
   int count;
   ar >> BOOST_SERIALIZATION_NVP(count);
   t.clear();
@@ -251,8 +251,8 @@ inline void load(Archive& ar, unordered_set<T>& t, unsigned int){
   }
 }
 
-template<class Archive, class T>
-inline void serialize(Archive& ar, unordered_set<T>& t, unsigned int file_version){
+template<class Archive, class T, class H>
+inline void serialize(Archive& ar, unordered_set<T, H>& t, unsigned int file_version){
   boost::serialization::split_free(ar, t, file_version);
 }
 
@@ -18,6 +18,7 @@
 #include "shortest_path.h"
 #include "level.h"
 #include "creature.h"
+#include "profiler.h"
 
 template <class Archive> 
 void ShortestPath::serialize(Archive& ar, const unsigned int version) {
@@ -99,6 +100,7 @@ ShortestPath::ShortestPath(Rectangle a, function<double(Vec2)> entryFun, functio
 
 void ShortestPath::init(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, Vec2 target,
     Optional<Vec2> from, Optional<int> limit) {
+  PROFILE("shortest path");
   reversed = false;
   distanceTable.clear();
   function<bool(Vec2, Vec2)> comparator;
@@ -116,9 +118,9 @@ void ShortestPath::init(function<double(Vec2)> entryFun, function<double(Vec2)>
   while (!q.empty()) {
     ++numPopped;
     Vec2 pos = q.top();
-   // Debug() << "Popping " << pos << " " << distance[pos]  << " " << (from ? (*from - pos).length4() : 0);
+   // LOG << "Popping " << pos << " " << distance[pos]  << " " << (from ? (*from - pos).length4() : 0);
     if (from == pos || (limit && distanceTable.getDistance(pos) >= *limit)) {
-      Debug() << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
+      LOG << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
         << " visited distance " << distanceTable.getDistance(pos);
       constructPath(pos);
       return;
@@ -140,7 +142,7 @@ void ShortestPath::init(function<double(Vec2)> entryFun, function<double(Vec2)>
       }
     }
   }
-  Debug() << "Shortest path exhausted, " << numPopped << " visited";
+  LOG << "Shortest path exhausted, " << numPopped << " visited";
 }
 
 void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, double mult, Vec2 from,
@@ -163,7 +165,7 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
     ++numPopped;
     Vec2 pos = q.top();
     if (from == pos) {
-      Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+      LOG << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
       constructPath(pos, true);
       return;
     }
@@ -177,7 +179,7 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
         }
       }
   }
-  Debug() << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+  LOG << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
 }
 
 void ShortestPath::constructPath(Vec2 pos, bool reversed) {
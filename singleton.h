@@ -30,6 +30,9 @@ class Singleton {
   template <class Archive>
   static void serializeAll(Archive& ar) {
     ar & elems;
+    for (E id : EnumAll<E>())
+      if (elems[id])
+        elems[id]->id = id;
   }
 
   E getId() const;
@@ -18,6 +18,7 @@
 #include "square.h"
 #include "square_factory.h"
 #include "level.h"
+#include "event.h"
 
 template <class Archive> 
 void Square::serialize(Archive& ar, const unsigned int version) { 
@@ -39,6 +40,7 @@ void Square::serialize(Archive& ar, const unsigned int version) {
     & SVAR(poisonGas)
     & SVAR(constructions)
     & SVAR(ticking)
+    & SVAR(tickingIndex)
     & SVAR(fog);
   CHECK_SERIAL;
 }
@@ -164,8 +166,10 @@ void Square::tick(double time) {
   if (!inventory.isEmpty())
     for (Item* item : inventory.getItems()) {
       item->tick(time, level, position);
-      if (item->isDiscarded())
+      if (item->isDiscarded()) {
         inventory.removeItem(item);
+        EventListener::addItemsChangedEvent(level, position);
+      }
     }
   poisonGas.tick(level, position);
   if (creature && poisonGas.getAmount() > 0.2) {
@@ -173,7 +177,7 @@ void Square::tick(double time) {
   }
   if (fire.isBurning()) {
     viewObject.setBurning(fire.getSize());
-    Debug() << getName() << " burning " << fire.getSize();
+    LOG << getName() << " burning " << fire.getSize();
     for (Vec2 v : position.neighbors8(true))
       if (fire.getSize() > Random.getDouble() * 40)
         level->getSquare(v)->setOnFire(fire.getSize() / 20);
@@ -191,6 +195,33 @@ void Square::tick(double time) {
   for (Trigger* t : extractRefs(triggers))
     t->tick(time);
   tickSpecial(time);
+  if (!needsTicking())
+    level->removeTickingSquare(position);
+}
+
+bool Square::needsTicking() const {
+  if (ticking || fire.isBurning() || poisonGas.getAmount() > 0 || needsTickingSpecial())
+    return true;
+  for (const PTrigger& t : triggers)
+    if (t->needsTicking())
+      return true;
+  for (const Item* it : inventory.getItems())
+    if (it->needsTicking())
+      return true;
+  return false;
+}
+
+void Square::catchUp(double time, double elapsed) {
+  poisonGas.catchUp(elapsed);
+  if (fire.isBurning()) {
+    fire.catchUp(elapsed);
+    if (fire.isBurntOut()) {
+      burnOut();
+      return;
+    }
+    viewObject.setBurning(fire.getSize());
+  }
+  tick(time);
 }
 
 bool Square::itemLands(vector<Item*> item, const Attack& attack) {
@@ -257,6 +288,8 @@ void Square::setOnFire(double amount) {
     creature->setOnFire(amount);
   for (Item* it : getItems())
     it->setOnFire(amount, level, position);
+  if (!inventory.isEmpty())
+    level->addTickingSquare(position);
 }
 
 void Square::addPoisonGas(double amount) {
@@ -334,9 +367,11 @@ void Square::onEnter(Creature* c) {
 }
 
 void Square::dropItem(PItem item) {
-  if (level)  // if level == null, then it's being constructed, square will be added later
-    level->addTickingSquare(getPosition());
   inventory.addItem(std::move(item));
+  if (level) { // if level == null, then it's being constructed, square will be added later
+    level->addTickingSquare(getPosition());
+    EventListener::addItemsChangedEvent(level, position);
+  }
 }
 
 void Square::dropItems(vector<PItem> items) {
@@ -406,13 +441,15 @@ int Square::getStrength() const {
 
 Item* Square::getTopItem() const {
   Item* last = nullptr;
+  Item* large = nullptr;
   if (!inventory.isEmpty())
   for (Item* it : inventory.getItems()) {
-    last = it;
-    if (it->getViewObject().layer() == ViewLayer::LARGE_ITEM)
-      return it;
+    if (!last || inventory.isAddedBefore(last, it))
+      last = it;
+    if (it->getViewObject().layer() == ViewLayer::LARGE_ITEM && (!large || inventory.isAddedBefore(it, large)))
+      large = it;
   }
-  return last;
+  return large ? large : last;
 }
 
 vector<Item*> Square::getItems(function<bool (Item*)> predicate) {
@@ -420,10 +457,14 @@ vector<Item*> Square::getItems(function<bool (Item*)> predicate) {
 }
 
 PItem Square::removeItem(Item* it) {
-  return inventory.removeItem(it);
+  PItem ret = inventory.removeItem(it);
+  EventListener::addItemsChangedEvent(level, position);
+  return ret;
 }
 
 vector<PItem> Square::removeItems(vector<Item*> it) {
-  return inventory.removeItems(it);
+  vector<PItem> ret = inventory.removeItems(it);
+  EventListener::addItemsChangedEvent(level, position);
+  return ret;
 }
 
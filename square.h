@@ -168,6 +168,14 @@ class Square {
       For this method to be called, the square coordinates must be added with Level::addTickingSquare().*/
   void tick(double time);
 
+  /** Applies \paramname{elapsed} turns of fire and gas in aggregate, and then ticks the square once.
+      Used when a dormant level is woken up. See Level::wakeUp().*/
+  void catchUp(double time, double elapsed);
+
+  /** Checks if anything on the square is still time-dependent, ie. fire, gas, ticking triggers or items.
+      If not, the square is removed from the level's ticking squares after its tick.*/
+  bool needsTicking() const;
+
   virtual bool canLock() const { return false; }
   virtual bool isLocked() const { FAIL << "BAD"; return false; }
   virtual void lock() { FAIL << "BAD"; }
@@ -200,12 +208,14 @@ class Square {
   virtual bool canEnterSpecial(const Creature*) const;
   virtual void onEnterSpecial(Creature*) {}
   virtual void tickSpecial(double time) {}
+  virtual bool needsTickingSpecial() const { return false; }
   Level* getLevel();
   Inventory SERIAL(inventory);
   string SERIAL(name);
   ViewObject SERIAL(viewObject);
 
   private:
+  friend class Level;
   Item* getTopItem() const;
 
   Level* SERIAL2(level, nullptr);
@@ -223,6 +233,7 @@ class Square {
   PoisonGas SERIAL(poisonGas);
   map<SquareType, int> SERIAL(constructions);
   bool SERIAL(ticking);
+  int SERIAL2(tickingIndex, -1);
   double SERIAL2(fog, 0);
 };
 
@@ -382,7 +382,7 @@ PTask Task::applyItem(Callback* col, Vec2 position, Item* item, Vec2 target) {
 
 class ApplySquare : public Task {
   public:
-  ApplySquare(Callback* col, set<Vec2> pos) : Task(col, Vec2(-1, 1)), positions(pos) {}
+  ApplySquare(Callback* col, vector<Vec2> pos) : Task(col, Vec2(-1, 1)), positions(pos) {}
 
   virtual bool canTransfer() override {
     return false;
@@ -444,12 +444,12 @@ class ApplySquare : public Task {
   SERIALIZATION_CONSTRUCTOR(ApplySquare);
 
   private:
-  set<Vec2> SERIAL(positions);
+  vector<Vec2> SERIAL(positions);
   set<Vec2> SERIAL(rejectedPosition);
   int SERIAL2(invalidCount, 5);
 };
 
-PTask Task::applySquare(Callback* col, set<Vec2> position) {
+PTask Task::applySquare(Callback* col, vector<Vec2> position) {
   CHECK(position.size() > 0);
   return PTask(new ApplySquare(col, position));
 }
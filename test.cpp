@@ -21,6 +21,22 @@
 #include "level_maker.h"
 #include "test.h"
 #include "sectors.h"
+#include "timer_wheel.h"
+#include "event.h"
+#include "tile_set.h"
+#include "delay_map.h"
+#include "profiler.h"
+#include "creature.h"
+#include "collective.h"
+#include "inventory.h"
+#include "item.h"
+#include "map_memory.h"
+#include "model.h"
+#include "level.h"
+#include "creature_factory.h"
+#include "tribe.h"
+#include "vision.h"
+#include "skill.h"
 
 void testStringConvertion() {
   CHECK(convertToString(1234) == "1234");
@@ -404,6 +420,432 @@ void testReverse3() {
   CHECKEQ(reverse2(v1), v2);
 }
 
+void testTimerWheel() {
+  TimerWheel<int> wheel;
+  wheel.schedule(5.5, 1);
+  wheel.schedule(3, 2);
+  wheel.schedule(700, 3);
+  wheel.schedule(100000, 4);
+  CHECK(wheel.popDue(3).empty());
+  CHECKEQ(wheel.popDue(3.5), vector<int>({2}));
+  CHECK(wheel.popDue(5.5).empty());
+  CHECKEQ(wheel.popDue(6), vector<int>({1}));
+  CHECK(wheel.popDue(699).empty());
+  CHECKEQ(wheel.popDue(701), vector<int>({3}));
+  CHECKEQ(wheel.getSize(), 1);
+  CHECKEQ(wheel.popDue(100001), vector<int>({4}));
+  CHECKEQ(wheel.getSize(), 0);
+  wheel.schedule(100005, 5);
+  CHECK(wheel.popDue(100005).empty());
+  CHECKEQ(wheel.popDueInclusive(100005), vector<int>({5}));
+}
+
+// 300 creatures with 4 effects each, times out every effect exactly once.
+void testTimerWheelEffects() {
+  TimerWheel<int> wheel;
+  int numEntries = 300 * 4;
+  vector<int> timedOut(numEntries, 0);
+  vector<double> expiry(numEntries);
+  for (int i : Range(numEntries)) {
+    expiry[i] = 1 + Random.getDouble() * 2000;
+    wheel.schedule(expiry[i], i);
+  }
+  MEASURE({
+    for (int time : Range(1, 2002))
+      for (int i : wheel.popDue(time)) {
+        CHECK(expiry[i] < time && expiry[i] >= time - 1);
+        ++timedOut[i];
+      }
+  }, "timer wheel, 1200 effects, 2000 turns");
+  for (int i : Range(numEntries))
+    CHECKEQ(timedOut[i], 1);
+}
+
+void testConstructionQueue() {
+  TimerWheel<Vec2> queue;
+  DelayMap delays(Rectangle(10, 10));
+  Table<double> marked(10, 10, -1);
+  auto getMarked = [&] (Vec2 v) { return marked[v]; };
+  Vec2 due(1, 1), built(2, 2), remarked(3, 3), delayed(4, 4);
+  for (Vec2 v : {due, built, remarked, delayed}) {
+    marked[v] = 5;
+    queue.schedule(marked[v], v);
+  }
+  marked[built] = -1;
+  marked[remarked] = 8;
+  queue.schedule(marked[remarked], remarked);
+  delays.delay(delayed, 7);
+  CHECK(Collective::popDuePositions(queue, 4, delays, getMarked).empty());
+  CHECKEQ(Collective::popDuePositions(queue, 5, delays, getMarked), vector<Vec2>({due}));
+  CHECK(Collective::popDuePositions(queue, 6, delays, getMarked).empty());
+  CHECKEQ(Collective::popDuePositions(queue, 7, delays, getMarked), vector<Vec2>({delayed}));
+  CHECKEQ(Collective::popDuePositions(queue, 8, delays, getMarked), vector<Vec2>({remarked}));
+  CHECKEQ(queue.getSize(), 0);
+}
+
+// 500 queued constructions, each one is dispatched 4 times, 50 turns apart.
+void testConstructionQueueTime() {
+  TimerWheel<Vec2> queue;
+  DelayMap delays(Rectangle(25, 20));
+  Table<double> marked(25, 20);
+  Table<int> dispatched(25, 20, 0);
+  auto getMarked = [&] (Vec2 v) { return dispatched[v] < 4 ? marked[v] : -1; };
+  for (Vec2 v : marked.getBounds()) {
+    marked[v] = Random.getDouble() * 1000;
+    queue.schedule(marked[v], v);
+  }
+  MEASURE({
+    for (int time : Range(1, 10000))
+      for (Vec2 v : Collective::popDuePositions(queue, time, delays, getMarked)) {
+        CHECK(marked[v] <= time && marked[v] > time - 1);
+        if (++dispatched[v] < 4) {
+          marked[v] = time + 50;
+          queue.schedule(marked[v], v);
+        }
+      }
+  }, "construction queue, 500 constructions, 10000 turns");
+  CHECKEQ(queue.getSize(), 0);
+  for (Vec2 v : dispatched.getBounds())
+    CHECKEQ(dispatched[v], 4);
+}
+
+void testTileSet() {
+  TileSet s(Rectangle(10, 10));
+  CHECK(s.empty());
+  s.insert(Vec2(3, 4));
+  s.insert(Vec2(5, 5));
+  s.insert(Vec2(3, 4));
+  s.insert(Vec2(9, 9));
+  CHECKEQ(s.size(), 3);
+  CHECK(s.contains(Vec2(5, 5)));
+  CHECK(!s.contains(Vec2(4, 3)));
+  CHECK(!s.contains(Vec2(10, 10)));
+  s.erase(Vec2(3, 4));
+  s.erase(Vec2(1, 1));
+  CHECKEQ(s.size(), 2);
+  CHECK(!s.contains(Vec2(3, 4)));
+  CHECK(s.contains(Vec2(9, 9)));
+  CHECK(contains({Vec2(5, 5), Vec2(9, 9)}, s.getRandom()));
+  s.clear();
+  CHECK(s.empty());
+  CHECK(!s.contains(Vec2(5, 5)));
+}
+
+class TestListener : public EventListener {
+  public:
+  TestListener(vector<EventId> e) : events(e) {}
+
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return events;
+  }
+
+  virtual void onTriggerEvent(const Level*, Vec2 pos) override {
+    ++numTriggers;
+    if (onTrigger)
+      onTrigger();
+  }
+
+  vector<EventId> events;
+  int numTriggers = 0;
+  function<void()> onTrigger;
+};
+
+void testSmallFunction() {
+  int calls = 0;
+  SmallFunction f;
+  CHECK(!f);
+  f = [&] { ++calls; };
+  SmallFunction g = f;
+  f();
+  g();
+  CHECKEQ(calls, 2);
+  struct { int values[40]; } big;
+  big.values[0] = 1;
+  int numAllocations = SmallFunction::getNumAllocations();
+  SmallFunction h = [&calls, big] { calls += big.values[0]; };
+  SmallFunction h2 = h;
+  CHECKEQ(SmallFunction::getNumAllocations(), numAllocations + 2);
+  h = nullptr;
+  CHECK(!h);
+  h2();
+  CHECKEQ(calls, 3);
+  SmallFunction h3 = std::move(h2);
+  CHECK(!h2);
+  SmallFunction h4 = h2;
+  CHECK(!h4);
+  h2 = std::move(h3);
+  CHECK(!h3);
+  h2();
+  CHECKEQ(calls, 4);
+  CHECKEQ(SmallFunction::getNumAllocations(), numAllocations + 2);
+  auto counter = std::make_shared<int>(0);
+  {
+    SmallFunction k = [counter] { ++*counter; };
+    SmallFunction k2 = std::move(k);
+    CHECK(!k);
+    CHECKEQ(int(counter.use_count()), 2);
+    k = std::move(k2);
+    CHECK(!k2);
+    SmallFunction k3 = k2;
+    CHECK(!k3);
+    k();
+    CHECKEQ(int(counter.use_count()), 2);
+  }
+  CHECKEQ(*counter, 1);
+  CHECKEQ(int(counter.use_count()), 1);
+}
+
+PItem makeTestItem(ItemType type, double weight) {
+  return PItem(new Item(ViewObject(ViewId::GOLD, ViewLayer::ITEM, "Gold"), ITATTR(
+          i.name = "gold piece";
+          i.weight = weight;
+          i.type = type;)));
+}
+
+void testInventorySlots() {
+  Inventory inventory;
+  vector<Item*> items;
+  for (int i : Range(6)) {
+    PItem item = makeTestItem(i % 2 ? ItemType::GOLD : ItemType::FOOD, i);
+    items.push_back(item.get());
+    inventory.addItem(std::move(item));
+  }
+  PItem removed = inventory.removeItem(items[0]);
+  CHECK(!inventory.hasItem(items[0]));
+  inventory.removeItem(items[3]);
+  CHECK(!inventory.hasItem(items[3]));
+  for (int i : {1, 2, 4, 5})
+    CHECK(inventory.hasItem(items[i]));
+  CHECKEQ(inventory.size(), 4);
+  CHECK(inventory.getItems(ItemType::GOLD) == vector<Item*>({items[1], items[5]}));
+  CHECK(inventory.getItems(ItemType::FOOD) == vector<Item*>({items[4], items[2]}));
+  CHECK(inventory.getItems(ItemType::ARMOR).empty());
+  inventory.addItem(std::move(removed));
+  CHECK(inventory.hasItem(items[0]));
+  CHECK(inventory.isAddedBefore(items[1], items[5]));
+  CHECK(inventory.isAddedBefore(items[5], items[0]));
+  std::stringstream saved;
+  {
+    boost::archive::binary_oarchive output(saved);
+    output << inventory;
+  }
+  Inventory loaded;
+  {
+    boost::archive::binary_iarchive input(saved);
+    input >> loaded;
+  }
+  CHECKEQ(loaded.size(), 5);
+  CHECKEQ(int(loaded.getItems(ItemType::GOLD).size()), 2);
+  vector<double> weights;
+  for (PItem& item : loaded.removeAllItems())
+    weights.push_back(item->getWeight());
+  CHECKEQ(weights, vector<double>({1, 2, 4, 5, 0}));
+  vector<PItem> all = inventory.removeAllItems();
+  vector<Item*> order;
+  for (PItem& item : all)
+    order.push_back(item.get());
+  CHECK(order == vector<Item*>({items[1], items[2], items[4], items[5], items[0]}));
+  CHECK(inventory.isEmpty());
+  CHECK(inventory.getItems(ItemType::GOLD).empty());
+}
+
+void testActionChain() {
+  string order;
+  int numAllocations = SmallFunction::getNumAllocations();
+  Creature::Action action([&order] { order += "a"; });
+  action = action.append([&order] { order += "b"; })
+      .prepend([&order] { order += "c"; })
+      .append([&order] { order += "d"; });
+  CHECK(action);
+  action.perform();
+  CHECKEQ(order, "cabd");
+  CHECKEQ(SmallFunction::getNumAllocations(), numAllocations);
+  Creature::Action failed("no");
+  failed = failed.append([&order] { order += "e"; });
+  CHECK(!failed);
+  CHECKEQ(failed.getFailedReason(), "no");
+}
+
+void testMapMemory() {
+  MapMemory memory;
+  Vec2 pos(3, 4);
+  ViewObject floor(ViewId::FLOOR, ViewLayer::FLOOR, "Floor");
+  ViewObject gold(ViewId::GOLD, ViewLayer::ITEM, "Gold");
+  ViewIndex index;
+  index.insert(floor);
+  index.insert(ViewObject(ViewId::PLAYER, ViewLayer::CREATURE, "Player"));
+  CHECK(!memory.hasViewIndex(pos));
+  memory.update(pos, index);
+  CHECK(memory.getViewIndex(pos).getObject(ViewLayer::FLOOR) == floor);
+  CHECK(!memory.getViewIndex(pos).hasObject(ViewLayer::CREATURE));
+  CHECKEQ((int)memory.getViewIndex(pos).getHighlight().size(), 1);
+  memory.update(pos, index);
+  CHECKEQ((int)memory.getViewIndex(pos).getHighlight().size(), 1);
+  index.insert(gold);
+  index.addHighlight(HighlightType::FOG, 0.5);
+  memory.update(pos, index);
+  CHECK(memory.getViewIndex(pos).getObject(ViewLayer::ITEM) == gold);
+  CHECKEQ((int)memory.getViewIndex(pos).getHighlight().size(), 2);
+  index.removeObject(ViewLayer::ITEM);
+  memory.update(pos, index);
+  CHECK(!memory.getViewIndex(pos).hasObject(ViewLayer::ITEM));
+  floor.setModifier(ViewObject::PLANNED);
+  index.insert(floor);
+  memory.update(pos, index);
+  CHECK(memory.getViewIndex(pos).getObject(ViewLayer::FLOOR).hasModifier(ViewObject::PLANNED));
+}
+
+void testDelayMap() {
+  DelayMap m(Rectangle(10, 10));
+  m.delay(Vec2(3, 4), 20);
+  m.delay(Vec2(5, 5), 30);
+  m.delay(Vec2(3, 4), 25);
+  CHECKEQ(m.getSize(), 2);
+  CHECK(m.isDelayed(Vec2(3, 4), 24));
+  CHECK(!m.isDelayed(Vec2(3, 4), 25));
+  CHECK(!m.isDelayed(Vec2(1, 1), 0));
+  CHECKEQ(m.getDelayEnd(Vec2(5, 5)), 30);
+  m.expire(26);
+  CHECKEQ(m.getSize(), 1);
+  CHECK(m.getDelayEnd(Vec2(3, 4)) < 0);
+  CHECK(m.isDelayed(Vec2(5, 5), 26));
+  m.expire(30);
+  CHECKEQ(m.getSize(), 0);
+  CHECK(!m.isDelayed(Vec2(5, 5), 29));
+}
+
+void testProfiler() {
+  bool wasEnabled = Profiler::isEnabled();
+  Profiler::setEnabled(true);
+  Profiler::clear();
+  for (int i = 0; i < 10; ++i) {
+    PROFILE("outer");
+    for (int j = 0; j < 3; ++j) {
+      PROFILE("inner");
+    }
+  }
+  Profiler::endTurn();
+  const map<string, Profiler::Stats>& stats = Profiler::getTurnStats();
+  CHECKEQ(stats.at("outer").count, 10);
+  CHECKEQ(stats.at("inner").count, 30);
+  CHECK(stats.at("outer").mean >= stats.at("inner").mean);
+  CHECK(stats.at("inner").p95 <= stats.at("inner").max);
+  CHECKEQ(int(Profiler::getOverlay(stats).size()), 2);
+  Profiler::endFrame();
+  CHECKEQ(Profiler::getFrameStats().at("inner").count, 30);
+  {
+    PROFILE("later");
+  }
+  Profiler::endTurn();
+  CHECK(!Profiler::getTurnStats().count("outer"));
+  CHECKEQ(Profiler::getTurnStats().at("later").count, 1);
+  Profiler::endFrame();
+  CHECK(!Profiler::getFrameStats().count("outer"));
+  CHECKEQ(Profiler::getFrameStats().at("later").count, 1);
+  Profiler::setEnabled(false);
+  {
+    PROFILE("disabled");
+  }
+  Profiler::endTurn();
+  CHECK(Profiler::getTurnStats().empty());
+  Profiler::setEnabled(wasEnabled);
+}
+
+void testEventListener() {
+  TestListener a({EventId::TRIGGER});
+  TestListener b({EventId::KILL, EventId::TRIGGER});
+  unique_ptr<TestListener> c(new TestListener({EventId::TRIGGER}));
+  TestListener d({EventId::KILL});
+  a.onTrigger = [&] { c.reset(); };
+  EventListener::addTriggerEvent(nullptr, Vec2(0, 0));
+  CHECK(!c);
+  CHECKEQ(a.numTriggers, 1);
+  CHECKEQ(b.numTriggers, 1);
+  CHECKEQ(d.numTriggers, 0);
+  EventListener::addTriggerEvent(nullptr, Vec2(0, 0));
+  CHECKEQ(a.numTriggers, 2);
+  CHECKEQ(b.numTriggers, 2);
+}
+
+// Most listeners (eg. monster behaviours) don't care about a given event kind.
+void testEventListenerDispatch() {
+  vector<unique_ptr<TestListener>> silent;
+  for (int i : Range(1000))
+    silent.emplace_back(new TestListener({EventId::KILL}));
+  TestListener a({EventId::TRIGGER});
+  MEASURE({
+    for (int i : Range(100000))
+      EventListener::addTriggerEvent(nullptr, Vec2(0, 0));
+  }, "100000 events, 1000 unsubscribed listeners");
+  CHECKEQ(a.numTriggers, 100000);
+  for (auto& l : silent)
+    CHECKEQ(l->numTriggers, 0);
+}
+
+// 300 elves and goblins on a forest level, every one of them updating the creatures it can see.
+void testVisibleCreaturesTime() {
+  Vision::clearAll();
+  Vision::init();
+  Tribe::clearAll();
+  Tribe::init();
+  Skill::clearAll();
+  Skill::init();
+  Model model(nullptr);
+  Level::Builder builder(60, 60, "test", false);
+  PLevel level = builder.build(&model, LevelMaker::grassAndTrees());
+  vector<Creature*> creatures;
+  for (int i : Range(300)) {
+    PCreature c = i % 2 ? CreatureFactory::fromId(CreatureId::ELF, Tribe::get(TribeId::ELVEN))
+        : CreatureFactory::fromId(CreatureId::GOBLIN, Tribe::get(TribeId::GOBLIN));
+    Vec2 pos;
+    do {
+      pos = Vec2(Random.getRandom(60), Random.getRandom(60));
+    } while (!level->getSquare(pos)->canEnter(c.get()));
+    creatures.push_back(c.get());
+    level->addCreature(pos, std::move(c));
+  }
+  // computes the fields of view, which are cached afterwards
+  for (Creature* c : creatures)
+    c->updateVisibleCreatures();
+  MEASURE({
+    for (int turn : Range(10))
+      for (Creature* c : creatures)
+        c->updateVisibleCreatures();
+  }, "visible creatures, 300 creatures, 10 turns");
+  int numEnemies = 0;
+  for (Creature* c : creatures)
+    for (const Creature* other : c->getVisibleEnemies()) {
+      CHECK(other->getTribe() != c->getTribe());
+      ++numEnemies;
+    }
+  CHECK(numEnemies > 0);
+}
+
+// Log lines written during moves: flushed one by one as before, queued, and queued with logging off.
+void testLogTime() {
+  const int numLines = 10000;
+  {
+    ofstream out("log_test.out");
+    MEASURE({
+      for (int i : Range(numLines))
+        out << "INFO " + string() + ":" + convertToString(0) + " " + "Creature moved in turn " + convertToString(i)
+            << endl;
+    }, "10000 log lines, written synchronously");
+  }
+  remove("log_test.out");
+  MEASURE({
+    for (int i : Range(numLines))
+      LOG << "Creature moved in turn " << i;
+  }, "10000 log lines, queued");
+  bool wasLogging = Debug::isLogging();
+  Debug::setLogging(false);
+  MEASURE({
+    for (int i : Range(numLines))
+      LOG << "Creature moved in turn " << i;
+  }, "10000 log lines, logging off");
+  Debug::setLogging(wasLogging);
+}
+
 int testAll() {
   Debug::init();
   testStringConvertion();
@@ -437,6 +879,21 @@ int testAll() {
   testReverse();
   testReverse2();
   testReverse3();
+  testTimerWheel();
+  testTimerWheelEffects();
+  testConstructionQueue();
+  testConstructionQueueTime();
+  testTileSet();
+  testDelayMap();
+  testMapMemory();
+  testSmallFunction();
+  testActionChain();
+  testInventorySlots();
+  testProfiler();
+  testEventListener();
+  testEventListenerDispatch();
+  testVisibleCreaturesTime();
+  testLogTime();
   Debug() << "-----===== OK =====-----";
   return 0;
 }
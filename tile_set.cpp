@@ -0,0 +1,117 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#include "stdafx.h"
+#include "tile_set.h"
+
+template <class Archive> 
+void TileSet::serialize(Archive& ar, const unsigned int version) {
+  boost::serialization::split_member(ar, *this, version);
+}
+
+// The membership is stored as lengths of alternating runs of absent and present tiles.
+template <class Archive> 
+void TileSet::save(Archive& ar, const unsigned int version) const {
+  vector<int> runs;
+  bool present = false;
+  int length = 0;
+  for (Vec2 v : bounds) {
+    if (contains(v) != present) {
+      runs.push_back(length);
+      length = 0;
+      present = !present;
+    }
+    ++length;
+  }
+  runs.push_back(length);
+  ar << BOOST_SERIALIZATION_NVP(bounds) << BOOST_SERIALIZATION_NVP(runs);
+}
+
+template <class Archive> 
+void TileSet::load(Archive& ar, const unsigned int version) {
+  vector<int> runs;
+  ar >> BOOST_SERIALIZATION_NVP(bounds) >> BOOST_SERIALIZATION_NVP(runs);
+  indices = Table<int>(bounds, -1);
+  elems.clear();
+  int run = 0;
+  int length = 0;
+  for (Vec2 v : bounds) {
+    while (length == runs[run]) {
+      ++run;
+      length = 0;
+    }
+    if (run % 2 == 1)
+      insert(v);
+    ++length;
+  }
+}
+
+SERIALIZABLE(TileSet);
+
+TileSet::TileSet(Rectangle b) : bounds(b), indices(bounds, -1) {
+}
+
+void TileSet::insert(Vec2 pos) {
+  if (indices[pos] > -1)
+    return;
+  indices[pos] = elems.size();
+  elems.push_back(pos);
+}
+
+void TileSet::erase(Vec2 pos) {
+  int index = indices[pos];
+  if (index == -1)
+    return;
+  indices[pos] = -1;
+  elems[index] = elems.back();
+  elems.pop_back();
+  if (index < elems.size())
+    indices[elems[index]] = index;
+}
+
+bool TileSet::contains(Vec2 pos) const {
+  return pos.inRectangle(bounds) && indices[pos] > -1;
+}
+
+bool TileSet::empty() const {
+  return elems.empty();
+}
+
+int TileSet::size() const {
+  return elems.size();
+}
+
+void TileSet::clear() {
+  for (Vec2 v : elems)
+    indices[v] = -1;
+  elems.clear();
+}
+
+Vec2 TileSet::getRandom() const {
+  CHECK(!elems.empty());
+  return elems[Random.getRandom(elems.size())];
+}
+
+const vector<Vec2>& TileSet::getAll() const {
+  return elems;
+}
+
+vector<Vec2>::const_iterator TileSet::begin() const {
+  return elems.begin();
+}
+
+vector<Vec2>::const_iterator TileSet::end() const {
+  return elems.end();
+}
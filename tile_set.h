@@ -0,0 +1,54 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _TILE_SET_H
+#define _TILE_SET_H
+
+#include "util.h"
+
+/** A set of positions within fixed bounds. Membership is checked in a table of indices,
+    and the elements are also kept in a vector for fast iteration and random choice.
+    Iteration order is arbitrary and changes when elements are removed.*/
+class TileSet {
+  public:
+  TileSet(Rectangle bounds);
+
+  void insert(Vec2);
+  void erase(Vec2);
+  bool contains(Vec2) const;
+  bool empty() const;
+  int size() const;
+  void clear();
+
+  Vec2 getRandom() const;
+  const vector<Vec2>& getAll() const;
+  vector<Vec2>::const_iterator begin() const;
+  vector<Vec2>::const_iterator end() const;
+
+  SERIALIZATION_DECL(TileSet);
+
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const;
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version);
+
+  private:
+  Rectangle bounds;
+  Table<int> indices;
+  vector<Vec2> elems;
+};
+
+#endif
@@ -22,7 +22,8 @@ template <class Archive>
 void TimeQueue::serialize(Archive& ar, const unsigned int version) { 
   ar& SVAR(creatures)
     & SVAR(queue)
-    & SVAR(dead);
+    & SVAR(dead)
+    & SVAR(suspended);
   CHECK_SERIAL;
 }
 
@@ -56,10 +57,22 @@ PCreature TimeQueue::removeCreature(Creature* cRef) {
   CHECK(ind > -1) << "Creature not found";
   PCreature ret = std::move(creatures[ind]);
   creatures.erase(creatures.begin() + ind);
-  dead.insert(ret.get());
+  if (!suspended.erase(ret.get()))
+    dead.insert(ret.get());
   return ret;
 }
 
+void TimeQueue::suspendCreature(Creature* c) {
+  CHECK(!queue.empty() && queue.top().creature == c) << "Only the next creature can be suspended";
+  queue.pop();
+  suspended.insert(c);
+}
+
+void TimeQueue::resumeCreature(Creature* c) {
+  if (suspended.erase(c))
+    queue.push({c, c->getTime()});
+}
+
 vector<Creature*> TimeQueue::getAllCreatures() const {
   vector<Creature*> ret;
   for (const PCreature& c : creatures)
@@ -28,6 +28,13 @@ class TimeQueue {
   PCreature removeCreature(Creature* c);
   double getCurrentTime();
 
+  /** Takes the creature returned by getNextCreature() out of the queue. The creature remains owned
+    * by the queue, but won't move until resumeCreature() is called.*/
+  void suspendCreature(Creature* c);
+
+  /** Puts a suspended creature back in the queue. Does nothing if the creature isn't suspended.*/
+  void resumeCreature(Creature* c);
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
@@ -48,6 +55,7 @@ class TimeQueue {
   };
   priority_queue<QElem, vector<QElem>, function<bool(QElem, QElem)>> SERIAL(queue);
   unordered_set<Creature*> SERIAL(dead);
+  unordered_set<Creature*> SERIAL(suspended);
 };
 
 #endif
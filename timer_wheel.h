@@ -0,0 +1,171 @@
+/* Copyright (C) 2013-2014 Michal Brzozowski (rusolis@poczta.fm)
+
+   This file is part of KeeperRL.
+
+   KeeperRL is free software; you can redistribute it and/or modify it under the terms of the
+   GNU General Public License as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   KeeperRL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+   even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with this program.
+   If not, see http://www.gnu.org/licenses/ . */
+
+#ifndef _TIMER_WHEEL_H
+#define _TIMER_WHEEL_H
+
+#include "util.h"
+
+/** Schedules elements to be returned once the game time passes a given point. The cost of popping
+  * due elements depends only on the number of due elements, not on the number of all scheduled ones.
+  * Elements due within the current 256 turns are kept in per-turn slots, elements due within 65536 turns
+  * in per-256-turn slots that are cascaded to the finer ones when their time comes, and the rest in
+  * an overflow list.*/
+template <class T>
+class TimerWheel {
+  public:
+  TimerWheel();
+
+  /** Schedules \paramname{elem} to be returned by popDue() once the time passes \paramname{time}.*/
+  void schedule(double time, const T& elem);
+
+  /** Returns all elements scheduled for a time earlier than \paramname{time}. Times must not decrease
+      between calls.*/
+  vector<T> popDue(double time);
+
+  /** Returns all elements scheduled for a time not later than \paramname{time}. Times must not decrease
+      between calls.*/
+  vector<T> popDueInclusive(double time);
+
+  int getSize() const;
+  void clear();
+
+  SERIAL_CHECKER;
+
+  template <class Archive> 
+  void serialize(Archive& ar, const unsigned int version);
+
+  private:
+  static const int numSlots = 256;
+  static const int slotBits = 8;
+  struct Entry {
+    double time;
+    T elem;
+
+    template <class Archive> 
+    void serialize(Archive& ar, const unsigned int version);
+  };
+  void insert(const Entry&);
+  void advance();
+  vector<T> pop(double time, bool inclusive);
+  vector<vector<Entry>> SERIAL(turns);
+  vector<vector<Entry>> SERIAL(blocks);
+  vector<Entry> SERIAL(overflow);
+  int SERIAL2(cursor, 0);
+  int SERIAL2(size, 0);
+};
+
+template <class T>
+template <class Archive>
+void TimerWheel<T>::serialize(Archive& ar, const unsigned int version) {
+  ar& SVAR(turns)
+    & SVAR(blocks)
+    & SVAR(overflow)
+    & SVAR(cursor)
+    & SVAR(size);
+  CHECK_SERIAL;
+}
+
+template <class T>
+template <class Archive>
+void TimerWheel<T>::Entry::serialize(Archive& ar, const unsigned int version) {
+  ar& BOOST_SERIALIZATION_NVP(time)
+    & BOOST_SERIALIZATION_NVP(elem);
+}
+
+template <class T>
+TimerWheel<T>::TimerWheel() : turns(numSlots), blocks(numSlots) {
+}
+
+template <class T>
+void TimerWheel<T>::insert(const Entry& entry) {
+  int turn = max(cursor, int(floor(entry.time)));
+  int block = turn >> slotBits;
+  int cursorBlock = cursor >> slotBits;
+  if (block == cursorBlock)
+    turns[turn & (numSlots - 1)].push_back(entry);
+  else if (block - cursorBlock < numSlots)
+    blocks[block & (numSlots - 1)].push_back(entry);
+  else
+    overflow.push_back(entry);
+}
+
+template <class T>
+void TimerWheel<T>::schedule(double time, const T& elem) {
+  insert({time, elem});
+  ++size;
+}
+
+template <class T>
+void TimerWheel<T>::advance() {
+  ++cursor;
+  if ((cursor & (numSlots - 1)) == 0) {
+    vector<Entry> cascaded;
+    cascaded.swap(blocks[(cursor >> slotBits) & (numSlots - 1)]);
+    if (((cursor >> slotBits) & (numSlots - 1)) == 0) {
+      append(cascaded, overflow);
+      overflow.clear();
+    }
+    for (const Entry& entry : cascaded)
+      insert(entry);
+  }
+}
+
+template <class T>
+vector<T> TimerWheel<T>::popDue(double time) {
+  return pop(time, false);
+}
+
+template <class T>
+vector<T> TimerWheel<T>::popDueInclusive(double time) {
+  return pop(time, true);
+}
+
+template <class T>
+vector<T> TimerWheel<T>::pop(double time, bool inclusive) {
+  vector<T> ret;
+  int target = floor(time);
+  while (cursor < target && size > 0) {
+    vector<Entry>& slot = turns[cursor & (numSlots - 1)];
+    for (const Entry& entry : slot)
+      ret.push_back(entry.elem);
+    size -= slot.size();
+    slot.clear();
+    advance();
+  }
+  if (size == 0)
+    cursor = max(cursor, target);
+  vector<Entry>& slot = turns[cursor & (numSlots - 1)];
+  for (int i = 0; i < slot.size(); ++i)
+    if (slot[i].time < time || (inclusive && slot[i].time == time)) {
+      ret.push_back(slot[i].elem);
+      slot.erase(slot.begin() + i);
+      --size;
+      --i;
+    }
+  return ret;
+}
+
+template <class T>
+int TimerWheel<T>::getSize() const {
+  return size;
+}
+
+template <class T>
+void TimerWheel<T>::clear() {
+  *this = TimerWheel<T>();
+}
+
+#endif
@@ -19,9 +19,14 @@
 
 template <class Archive> 
 void Tribe::serialize(Archive& ar, const unsigned int version) {
+  // slots are assigned anew when loading, so the standing is saved by creature
+  unordered_map<const Creature*, double> standingByCreature;
+  for (auto& elem : standing)
+    if (elem.first)
+      standingByCreature[elem.first] = elem.second;
   ar& SUBCLASS(EventListener)
     & SVAR(diplomatic)
-    & SVAR(standing)
+    & boost::serialization::make_nvp("standing", standingByCreature)
     & SVAR(attacks)
     & SVAR(leader)
     & SVAR(members)
@@ -29,6 +34,8 @@ void Tribe::serialize(Archive& ar, const unsigned int version) {
     & SVAR(name)
     & SVAR(handicap);
   CHECK_SERIAL;
+  for (auto& elem : standingByCreature)
+    setStanding(elem.first, elem.second);
 }
 
 SERIALIZABLE(Tribe);
@@ -84,25 +91,42 @@ const string& Tribe::getName() {
 double Tribe::getStanding(const Creature* c) const {
   if (c->getTribe() == this)
     return 1;
-  if (standing.count(c)) 
-    return standing.at(c);
-  if (enemyTribes.count(c->getTribe()))
+  if (const double* s = findStanding(c))
+    return *s;
+  if (enemyTribes[c->getTribe()->getId()])
     return -1;
   return 0;
 }
 
-void Tribe::initStanding(const Creature* c) {
-  standing[c] = getStanding(c);
+const double* Tribe::findStanding(const Creature* c) const {
+  int slot = c->getSlot();
+  if (slot >= 0 && slot < standing.size() && standing[slot].first == c)
+    return &standing[slot].second;
+  else
+    return nullptr;
+}
+
+void Tribe::setStanding(const Creature* c, double value) {
+  int slot = c->getSlot();
+  if (slot < 0)
+    return;
+  if (slot >= standing.size())
+    standing.resize(slot + 1, make_pair(nullptr, 0.0));
+  standing[slot] = make_pair(c, value);
+}
+
+void Tribe::changeStanding(const Creature* c, double diff) {
+  setStanding(c, getStanding(c) + diff);
 }
 
 void Tribe::addEnemy(Tribe* t) {
   CHECK(t != this);
-  enemyTribes.insert(t);
-  t->enemyTribes.insert(this);
+  enemyTribes.insert(t->getId());
+  t->enemyTribes.insert(getId());
 }
 
 void Tribe::makeSlightEnemy(const Creature* c) {
-  standing[c] = -0.001;
+  setStanding(c, -0.001);
 }
 
 static const double killBonus = 0.1;
@@ -118,29 +142,41 @@ double Tribe::getMultiplier(const Creature* member) {
     return 1;
 }
 
+vector<EventId> Tribe::getSubscribedEvents() const {
+  return {EventId::KILL, EventId::ATTACK};
+}
+
+void Tribe::forget(const Creature* c) {
+  if (findStanding(c))
+    standing[c->getSlot()].first = nullptr;
+  for (auto it = attacks.begin(); it != attacks.end();)
+    if (it->first == c || it->second == c)
+      it = attacks.erase(it);
+    else
+      ++it;
+}
+
 void Tribe::onKillEvent(const Creature* member, const Creature* attacker) {
+  forget(member);
   if (contains(members, member)) {
     CHECK(member->getTribe() == this);
     if (attacker == nullptr)
       return;
-    initStanding(attacker);
-    standing[attacker] -= killPenalty * getMultiplier(member);
-    for (Tribe* t : enemyTribes)
-      if (t->diplomatic) {
-        t->initStanding(attacker);
-        t->standing[attacker] += killBonus * getMultiplier(member);
-      }
+    changeStanding(attacker, -killPenalty * getMultiplier(member));
+    for (TribeId id : enemyTribes) {
+      Tribe* t = Tribe::get(id);
+      if (t->diplomatic)
+        t->changeStanding(attacker, killBonus * getMultiplier(member));
+    }
   }
 }
 
 void Tribe::onAttackEvent(const Creature* member, const Creature* attacker) {
   if (member->getTribe() != this)
     return;
-  if (contains(attacks, make_pair(member, attacker)))
+  if (!attacks.insert(make_pair(member, attacker)).second)
     return;
-  attacks.emplace_back(member, attacker);
-  initStanding(attacker);
-  standing[attacker] -= attackPenalty * getMultiplier(member);
+  changeStanding(attacker, -attackPenalty * getMultiplier(member));
 }
 
 void Tribe::addMember(const Creature* c) {
@@ -165,8 +201,7 @@ vector<const Creature*> Tribe::getMembers(bool includeDead) {
 
 void Tribe::onItemsStolen(const Creature* attacker) {
   if (diplomatic) {
-    initStanding(attacker);
-    standing[attacker] -= thiefPenalty;
+    changeStanding(attacker, -thiefPenalty);
   }
 }
 
@@ -28,6 +28,7 @@ class Tribe : public EventListener, public Singleton<Tribe, TribeId> {
   public:
   virtual double getStanding(const Creature*) const;
 
+  virtual vector<EventId> getSubscribedEvents() const override;
   virtual void onKillEvent(const Creature* victim, const Creature* killer) override;
   virtual void onAttackEvent(const Creature* victim, const Creature* attacker) override;
 
@@ -57,14 +58,20 @@ class Tribe : public EventListener, public Singleton<Tribe, TribeId> {
 
   bool SERIAL(diplomatic);
 
-  void initStanding(const Creature*);
+  void setStanding(const Creature*, double);
+  void changeStanding(const Creature*, double);
+  const double* findStanding(const Creature*) const;
+  /** Drops the per-creature standing and attack records of a dead creature.*/
+  void forget(const Creature*);
   double getMultiplier(const Creature* member);
 
-  unordered_map<const Creature*, double> SERIAL(standing);
-  vector<pair<const Creature*, const Creature*>> SERIAL(attacks);
+  /** Per-creature standing indexed by Creature::getSlot(). Slots are reused, so the creature is kept to
+    tell if the entry is still its own.*/
+  vector<pair<const Creature*, double>> standing;
+  unordered_set<pair<const Creature*, const Creature*>, PairHash> SERIAL(attacks);
   const Creature* SERIAL2(leader, nullptr);
   vector<const Creature*> SERIAL(members);
-  unordered_set<Tribe*> SERIAL(enemyTribes);
+  EnumSet<TribeId> SERIAL(enemyTribes);
   string SERIAL(name);
   int SERIAL2(handicap, 0);
 };
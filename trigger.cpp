@@ -46,6 +46,7 @@ bool Trigger::interceptsFlyingItem(Item* it) const { return false; }
 void Trigger::onInterceptFlyingItem(vector<PItem> it, const Attack& a, int remainingDist, Vec2 dir, Vision*) {}
 bool Trigger::isDangerous(const Creature* c) const { return false; }
 void Trigger::tick(double time) {}
+bool Trigger::needsTicking() const { return false; }
 
 class Portal : public Trigger {
   public:
@@ -103,6 +104,10 @@ class Portal : public Trigger {
     }
   }
 
+  virtual bool needsTicking() const override {
+    return true;
+  }
+
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
     ar& SUBCLASS(Trigger)
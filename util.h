@@ -177,6 +177,14 @@ template <class T> struct hash<std::set<T>> {
 
 }
 
+/** Hasher for unordered containers keyed by a pair.*/
+struct PairHash {
+  template <class T, class U>
+  size_t operator()(const pair<T, U>& p) const {
+    return std::hash<T>()(p.first) * 79146198 + std::hash<U>()(p.second);
+  }
+};
+
 class Rectangle {
   public:
   friend class Vec2;
@@ -587,6 +595,137 @@ function<bool(const T&)> andFun(function<bool(const T&)> x, const function<bool(
   return [x, y](T t) { return x(t) && y(t); };
 }
 
+/** A void() callable like function<void()>, but callables of up to 64 bytes are stored in place,
+    so that creating and copying them doesn't allocate. Bigger ones are kept on the heap.*/
+class SmallFunction {
+  public:
+  SmallFunction() {}
+  SmallFunction(std::nullptr_t) {}
+
+  template <class F, class = typename std::enable_if<
+      !std::is_same<typename std::decay<F>::type, SmallFunction>::value>::type,
+      class = decltype(std::declval<typename std::decay<F>::type&>()())>
+  SmallFunction(F&& f) : ops(&Ops<typename std::decay<F>::type>::table) {
+    Ops<typename std::decay<F>::type>::create(&storage, std::forward<F>(f));
+  }
+
+  SmallFunction(const SmallFunction& other) : ops(other.ops) {
+    if (ops)
+      ops->copy(&other.storage, &storage);
+  }
+
+  SmallFunction(SmallFunction&& other) : ops(other.ops) {
+    if (ops)
+      ops->move(&other.storage, &storage);
+    other.ops = nullptr;
+  }
+
+  SmallFunction& operator = (const SmallFunction& other) {
+    if (this != &other) {
+      reset();
+      ops = other.ops;
+      if (ops)
+        ops->copy(&other.storage, &storage);
+    }
+    return *this;
+  }
+
+  SmallFunction& operator = (SmallFunction&& other) {
+    if (this != &other) {
+      reset();
+      ops = other.ops;
+      if (ops)
+        ops->move(&other.storage, &storage);
+      other.ops = nullptr;
+    }
+    return *this;
+  }
+
+  ~SmallFunction() {
+    reset();
+  }
+
+  void operator()() const {
+    CHECK(ops);
+    ops->call(const_cast<Storage*>(&storage));
+  }
+
+  explicit operator bool() const {
+    return ops != nullptr;
+  }
+
+  /** Returns how many callables so far were too big to be stored in place and had to be allocated.*/
+  static int getNumAllocations() {
+    return numAllocations();
+  }
+
+  private:
+  static int& numAllocations() {
+    static int num = 0;
+    return num;
+  }
+
+  static const int bufferSize = 64;
+  typedef typename std::aligned_storage<bufferSize>::type Storage;
+
+  struct OpTable {
+    void (*call)(void*);
+    void (*copy)(const void*, void*);
+    // Moves the callable to dest and leaves nothing to destroy in src.
+    void (*move)(void*, void*);
+    void (*destroy)(void*);
+  };
+
+  template <class Fun, bool local = (sizeof(Fun) <= bufferSize && alignof(Fun) <= alignof(Storage))>
+  struct Ops {
+    template <class F>
+    static void create(void* dest, F&& f) { new (dest) Fun(std::forward<F>(f)); }
+    static void call(void* f) { (*static_cast<Fun*>(f))(); }
+    static void copy(const void* src, void* dest) { new (dest) Fun(*static_cast<const Fun*>(src)); }
+    static void move(void* src, void* dest) {
+      new (dest) Fun(std::move(*static_cast<Fun*>(src)));
+      destroy(src);
+    }
+    static void destroy(void* f) { static_cast<Fun*>(f)->~Fun(); }
+    static const OpTable table;
+  };
+
+  template <class Fun>
+  struct Ops<Fun, false> {
+    static Fun*& get(void* f) { return *static_cast<Fun**>(f); }
+    template <class F>
+    static void create(void* dest, F&& f) {
+      ++numAllocations();
+      get(dest) = new Fun(std::forward<F>(f));
+    }
+    static void call(void* f) { (*get(f))(); }
+    static void copy(const void* src, void* dest) {
+      ++numAllocations();
+      get(dest) = new Fun(*get(const_cast<void*>(src)));
+    }
+    static void move(void* src, void* dest) { get(dest) = get(src); get(src) = nullptr; }
+    static void destroy(void* f) { delete get(f); }
+    static const OpTable table;
+  };
+
+  void reset() {
+    if (ops)
+      ops->destroy(&storage);
+    ops = nullptr;
+  }
+
+  const OpTable* ops = nullptr;
+  Storage storage;
+};
+
+template <class Fun, bool local>
+const SmallFunction::OpTable SmallFunction::Ops<Fun, local>::table = {
+    &Ops<Fun, local>::call, &Ops<Fun, local>::copy, &Ops<Fun, local>::move, &Ops<Fun, local>::destroy};
+
+template <class Fun>
+const SmallFunction::OpTable SmallFunction::Ops<Fun, false>::table = {
+    &Ops<Fun, false>::call, &Ops<Fun, false>::copy, &Ops<Fun, false>::move, &Ops<Fun, false>::destroy};
+
 class OnExit {
   public:
   OnExit(function<void()> f) : fun(f) {}
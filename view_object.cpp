@@ -44,6 +44,15 @@ ViewObject::ViewObject(ViewId id, ViewLayer l, const string& d)
     modifiers[i] = false;
 }
 
+bool ViewObject::operator == (const ViewObject& o) const {
+  for (int i : Range(numModifiers))
+    if (modifiers[i] != o.modifiers[i])
+      return false;
+  return resource_id == o.resource_id && viewLayer == o.viewLayer && description == o.description
+      && bleeding == o.bleeding && enemyStatus == o.enemyStatus && burning == o.burning && height == o.height
+      && attack == o.attack && defense == o.defense && level == o.level && waterDepth == o.waterDepth;
+}
+
 ViewObject& ViewObject::setModifier(Modifier mod) {
   modifiers[int(mod)] = true;
   return *this;
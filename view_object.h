@@ -61,6 +61,8 @@ class ViewObject {
   ViewLayer layer() const;
   ViewId id() const;
 
+  bool operator == (const ViewObject&) const;
+
   const static ViewObject& unknownMonster();
   const static ViewObject& empty();
   const static ViewObject& mana();
@@ -114,6 +114,10 @@ void VillageControl::tick(double time) {
       c->increaseExpLevel(1);
 }
 
+vector<EventId> VillageControl::getSubscribedEvents() const {
+  return {EventId::KILL};
+}
+
 void VillageControl::onKillEvent(const Creature* victim, const Creature* killer) {
   if ((victim->getTribe() == tribe && (!killer ||  killer->getTribe() == Tribe::get(TribeId::KEEPER)))
       || (victim->getTribe() == Tribe::get(TribeId::KEEPER) && killer && killer->getTribe() == tribe))
@@ -171,7 +175,7 @@ class PowerTrigger : public AttackTriggerSet, public EventListener {
   double getCurrentTrigger(double time) {
     double enemyPoints = killedCoeff * killedPoints + powerCoeff * (control->villain->getDangerLevel()
       + max(0.0, (time - 1000) / 2));
-    Debug() << "Village " << control->name << " enemy points " << enemyPoints;
+    LOG << "Village " << control->name << " enemy points " << enemyPoints;
     double currentTrigger = 0;
     for (double trigger : triggerAmounts)
       if (trigger <= enemyPoints)
@@ -187,14 +191,18 @@ class PowerTrigger : public AttackTriggerSet, public EventListener {
     double myPower = 0;
     for (const Creature* c : control->allCreatures)
       myPower += c->getDifficultyPoints();
-    Debug() << "Village " << control->name << " power " << myPower;
+    LOG << "Village " << control->name << " power " << myPower;
     for (int i : Range(Random.getRandom(1, 3))) {
       double trigger = myPower * Random.getDouble(0.4, 1.2);
       triggerAmounts.insert(trigger);
-      Debug() << "Village " << control->name << " trigger " << trigger;
+      LOG << "Village " << control->name << " trigger " << trigger;
     }
   }
 
+  vector<EventId> getSubscribedEvents() const override {
+    return {EventId::KILL};
+  }
+
   void onKillEvent(const Creature* victim, const Creature* killer) override {
     if (victim->getTribe() == control->tribe && (!killer ||  killer->getTribe() == Tribe::get(TribeId::KEEPER))) {
       killedPoints += victim->getDifficultyPoints();
@@ -292,6 +300,10 @@ class FirstContact : public AttackTrigger, public EventListener {
     other->init();
   }
 
+  virtual vector<EventId> getSubscribedEvents() const override {
+    return {EventId::COMBAT};
+  }
+
   virtual void onCombatEvent(const Creature* c) override {
     CHECK(c != nullptr);
     if (contains(control->allCreatures, c))
@@ -38,6 +38,7 @@ class VillageControl : public EventListener, public Task::Callback {
   vector<Creature*> getAliveCreatures() const;
   bool currentlyAttacking() const;
 
+  virtual vector<EventId> getSubscribedEvents() const override;
   virtual void onKillEvent(const Creature* victim, const Creature* killer) override;
 
   View::GameInfo::VillageInfo::Village getVillageInfo() const;
@@ -25,6 +25,7 @@
 #include "location.h"
 #include "window_renderer.h"
 #include "tile.h"
+#include "profiler.h"
 
 using sf::Color;
 using sf::String;
@@ -835,6 +836,7 @@ void WindowView::updateMinimap(const CreatureView* creature) {
 }
 
 void WindowView::refreshViewInt(const CreatureView* collective, bool flipBuffer) {
+  PROFILE("render view");
   updateMinimap(collective);
   gameReady = true;
   switchTiles();
@@ -943,6 +945,22 @@ class FpsCounter {
   sf::Clock clock;
 } fpsCounter;
 
+enum class ProfilerOverlay { NONE, TURN, FRAME };
+static ProfilerOverlay profilerOverlay = ProfilerOverlay::NONE;
+
+static void drawProfiler() {
+  if (profilerOverlay == ProfilerOverlay::NONE)
+    return;
+  vector<string> lines;
+  if (profilerOverlay == ProfilerOverlay::FRAME) {
+    Profiler::endFrame();
+    lines = Profiler::getOverlay(Profiler::getFrameStats());
+  } else
+    lines = Profiler::getOverlay(Profiler::getTurnStats());
+  for (int i : All(lines))
+    renderer.drawText(white, renderer.getWidth() - 400, 80 + 20 * i, lines[i]);
+}
+
 
 void WindowView::drawMap() {
 /*  map<string, ViewObject> objIndex;
@@ -968,6 +986,7 @@ void WindowView::drawMap() {
   refreshText();
   fpsCounter.addTick();
   renderer.drawText(white, renderer.getWidth() - 70, renderer.getHeight() - 30, "FPS " + convertToString(fpsCounter.getFps()));
+  drawProfiler();
 }
 
 void WindowView::refreshScreen(bool flipBuffer) {
@@ -1431,6 +1450,20 @@ void WindowView::keyboardAction(Event::KeyEvent key) {
   switch (key.code) {
 #ifndef RELEASE
     case Keyboard::F8: renderer.startMonkey(); break;
+    case Keyboard::F9:
+      // cycles between per turn stats, per frame stats and no overlay
+      switch (profilerOverlay) {
+        case ProfilerOverlay::NONE: profilerOverlay = ProfilerOverlay::TURN; break;
+        case ProfilerOverlay::TURN:
+          profilerOverlay = ProfilerOverlay::FRAME;
+          // skip the zones recorded while the frame stats weren't displayed
+          Profiler::endFrame();
+          break;
+        case ProfilerOverlay::FRAME: profilerOverlay = ProfilerOverlay::NONE; break;
+      }
+      Profiler::setEnabled(true);
+      break;
+    case Keyboard::F10: Profiler::writeTrace("trace.json"); break;
 #endif
     case Keyboard::Z: switchZoom(); break;
     case Keyboard::F1:
@@ -1562,7 +1595,7 @@ Optional<Event::KeyEvent> WindowView::getEventFromMenu() {
       View::ListElem("Fire arrows with alt + arrow.", View::TITLE),
       View::ListElem("Choose action:", View::TITLE) };
   for (int i : All(keyInfo)) {
-    Debug() << "Action " << keyInfo[i].action;
+    LOG << "Action " << keyInfo[i].action;
     options.push_back(keyInfo[i].action + "   [ " + keyInfo[i].keyDesc + " ]");
   }
   vector<Event::KeyEvent> shortCuts;